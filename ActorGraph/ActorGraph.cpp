@@ -2,80 +2,67 @@
  * Actor Graph class implementation.
  */
 
-#include <fstream>
 #include <iostream>
-#include <sstream>
 #include <string>
 #include <vector>
 #include <queue>
 #include <stack>
 #include <limits>
 #include <map>
+#include <algorithm>
 #include "ActorGraph.h"
+#include "CastFileReader.h"
 #include "ComparePathCost.h"
+#include "ConcurrentDisjointSet.h"
+#include "Parallel.h"
 
 using namespace std;
 
+const uint32_t ActorGraph::NONE;
+const int ActorGraph::NO_WEIGHT;
+
 /* Insert node to graph.
  * Return true if node was inserted successfully, and false otherwise.
- * Inserting duplicate actor is not allowed.
+ * Inserting duplicate actor or inserting into a frozen graph is not allowed.
  */
-bool ActorGraph::insertNode(string actorName) {
-    try {
-        nodes.at(actorName);
+bool ActorGraph::insertNode(const string& actorName) {
+    if(frozen)
         return false;
-    }
-    catch (const std::out_of_range& oor) {
-        ActorNode* newNode = new ActorNode(actorName);   
-        nodes.insert({actorName, newNode});
-        return true;
-    }
-}
 
-/* Find the node with input actorName.
- * Return pointer to the node if found.
- * Return nullpointer if not found.
- */
-ActorNode* ActorGraph::findNode(string actorName) {
-    try {
-        return nodes.at(actorName);
-    } catch (const std::out_of_range& oor) {
-        return nullptr;
-    }
+    uint32_t num_actors = actors.size();
+    return actors.intern(actorName) == num_actors;
 }
 
-/* Insert an undirected edge to graph.
- * Return true if edge was inserted successfully, and false otherwise.
+/* Find the node with input actorName.
+ * Return the actor ID of the node if found.
+ * Return NONE if not found.
  */
-bool ActorGraph::insertEdge(string src, string dst, string movie, int year, int weight) {
-    if(!insertDirectedEdge(src, dst, movie, year, weight))
-        return false;
-    if(!insertDirectedEdge(dst, src, movie, year, weight))
-        return false;
-    return true;
+uint32_t ActorGraph::findNode(const string& actorName) const {
+    return actors.find(actorName);
 }
 
-/* Insert a directed edge to graph.
- * Return true if edge was inserted successfully, and false otherwise.
- * Self-loop is not allowed.
+/* Insert a movie and its cast, connecting every pair of its actors.
+ * Paths through the movie cost weight.
+ * Return true if movie was inserted successfully, and false otherwise.
+ * Inserting a movie twice or inserting into a frozen graph is not allowed.
  */
-bool ActorGraph::insertDirectedEdge(string src, string dst, string movie, int year, int weight) {
-    if(src == dst)
+bool ActorGraph::insertMovie(const MovieActorList& item, int weight) {
+    if(frozen || item.movie >= movies.size())
         return false;
 
-    auto srcNode = findNode(src);
-    if(!srcNode)
-        return false;
+    for(uint32_t actor : item.actorList) {
+        if(actor >= actors.size())
+            return false;
+    }
 
-    auto dstNode = findNode(dst);
-    if(!dstNode)
+    // Movies that have not been inserted yet have no weight
+    if(castWeights.size() < movies.size())
+        castWeights.resize(movies.size(), NO_WEIGHT);
+    if(castWeights[item.movie] != NO_WEIGHT)
         return false;
 
-    // Create edge
-    ActorEdge newEdge(dstNode, movie, year, weight);
-
-    // Insert edge
-    srcNode->adjList.push_back(newEdge);    
+    castLists.push_back(item);
+    castWeights[item.movie] = weight;
 
     return true;
 }
@@ -86,356 +73,1162 @@ bool ActorGraph::insertDirectedEdge(string src, string dst, string movie, int ye
  * use_weighted_edges - 
  *     if true, compute edge weights as 1 + (2015 - movie_year), 
  *     otherwise all edge weights will be 1
+ * num_threads - number of threads used to parse the file and build the graph
  *
  * Return true if file was loaded sucessfully, and false otherwise.
  */
-bool ActorGraph::loadFromFile(const char* in_filename, bool use_weighted_edges) {
-    // Initialize the file stream
-    ifstream infile(in_filename);
+bool ActorGraph::loadFromFile(const char* in_filename, bool use_weighted_edges,
+    unsigned num_threads) {
+    if(frozen)
+        return false;
+
+    // Movies and list of actors in that movie, ordered by year
+    vector<MovieActorList>* movie_list =
+        CastFileReader::readMovies(in_filename, actors, movies, num_threads);
+    if(!movie_list)
+        return false;
 
-    bool have_header = false;
+    // Add movies to graph using data from movie_list
+    for(auto& item : *movie_list) {
+        int weight;
+        if(use_weighted_edges)
+            weight = 1 + (2015 - item.year);
+        else
+            weight = 1;
 
-    // Create an ordered map to store movies and list of actors in that movie
-    // Key = to_string(movie_year) + movie_title (so keys are ordered by year)
-    map<string, MovieActorList*> movie_map;
+        insertMovie(item, weight);
+    }
 
-    // Keep reading lines until the end of file is reached
-    while(infile) {
-        string s;
+    delete movie_list;
 
-        // Get the next line
-        if(!getline(infile, s)) break;
+    weighted = use_weighted_edges;
+    freeze(num_threads);
 
-        if(!have_header) {
-            // skip the header
-            have_header = true;
-            continue;
+    return true;
+}
+
+/* Compact the inserted movies into the CSR arrays and release the
+ * cast lists. No nodes or movies can be inserted afterwards.
+ * With num_threads > 1, the arrays are counted and filled in parallel
+ * over ranges of movies. The result is identical to a single-threaded
+ * freeze. The graph is immutable once frozen, and only frozen graphs
+ * can be searched.
+ */
+void ActorGraph::freeze(unsigned num_threads) {
+    if(frozen)
+        return;
+
+    uint32_t num_actors = actors.size();
+    uint32_t num_movies = movies.size();
+    uint32_t num_items = castLists.size();
+    if(num_threads < 1)
+        num_threads = 1;
+
+    storage.movieYear.resize(num_movies);
+    storage.movieWeight.assign(num_movies, 0);
+    for(uint32_t m = 0; m < num_movies; m++)
+        storage.movieYear[m] = movies.year(m);
+
+    // Count cast per movie
+    storage.movieOffsets.assign(num_movies + 1, 0);
+    for(auto& item : castLists) {
+        storage.movieOffsets[item.movie + 1] = item.actorList.size();
+        storage.movieWeight[item.movie] = castWeights[item.movie];
+    }
+    for(uint32_t m = 0; m < num_movies; m++)
+        storage.movieOffsets[m + 1] += storage.movieOffsets[m];
+
+    // Count distinct movies per actor within each thread's range of movies
+    vector<vector<uint32_t>> counts(num_threads);
+    vector<vector<uint32_t>> lastMovie(num_threads);
+    parallelRanges(num_threads, num_items, [&](unsigned t, size_t begin, size_t end) {
+        counts[t].assign(num_actors, 0);
+        lastMovie[t].assign(num_actors, NONE);
+
+        for(size_t i = begin; i < end; i++) {
+            for(uint32_t actor : castLists[i].actorList) {
+                // Actors listed twice for a movie only get the movie once
+                if(lastMovie[t][actor] != castLists[i].movie) {
+                    lastMovie[t][actor] = castLists[i].movie;
+                    counts[t][actor]++;
+                }
+            }
         }
+    });
+
+    // Prefix sum over actors, then over threads within each actor, turning
+    // each thread's counts into the position of its first movie per actor
+    storage.actorOffsets.assign(num_actors + 1, 0);
+    for(uint32_t a = 0; a < num_actors; a++) {
+        uint32_t pos = storage.actorOffsets[a];
+        for(unsigned t = 0; t < num_threads; t++) {
+            uint32_t count = counts[t][a];
+            counts[t][a] = pos;
+            pos += count;
+        }
+        storage.actorOffsets[a + 1] = pos;
+    }
 
-        istringstream ss(s);
-        vector<string> record;
+    storage.movieActors.resize(storage.movieOffsets[num_movies]);
+    storage.actorMovies.resize(storage.actorOffsets[num_actors]);
 
-        while(ss) {
-            string next;
+    // Fill both directions in insertion order so searches visit neighbours
+    // in the order the movies and cast were inserted
+    parallelRanges(num_threads, num_items, [&](unsigned t, size_t begin, size_t end) {
+        vector<uint32_t>& next = counts[t];
+        fill(lastMovie[t].begin(), lastMovie[t].end(), NONE);
 
-            // Get the next string before hitting a tab character and put it in 'next'
-            if(!getline(ss, next, '\t')) 
-                break;
-            record.push_back(next);
-        }
+        for(size_t i = begin; i < end; i++) {
+            auto& item = castLists[i];
+            copy(item.actorList.begin(), item.actorList.end(),
+                storage.movieActors.begin() + storage.movieOffsets[item.movie]);
 
-        if(record.size() != 3) {
-            // We should have exactly 3 columns
-            continue;
+            for(uint32_t actor : item.actorList) {
+                if(lastMovie[t][actor] != item.movie) {
+                    lastMovie[t][actor] = item.movie;
+                    storage.actorMovies[next[actor]++] = item.movie;
+                }
+            }
         }
+    });
+
+    // Release the cast lists now that they live in the CSR arrays
+    vector<MovieActorList>().swap(castLists);
+    vector<int>().swap(castWeights);
+
+    actorOffsets = storage.actorOffsets;
+    actorMovies = storage.actorMovies;
+    movieOffsets = storage.movieOffsets;
+    movieActors = storage.movieActors;
+    movieYear = storage.movieYear;
+    movieWeight = storage.movieWeight;
+    computeWeightRange();
+    computeComponents(num_threads);
+
+    frozen = true;
+}
 
-        string actor_name(record[0]);
-        string movie_title(record[1]);
-        int movie_year = stoi(record[2]);
+/* Return a view of the CSR arrays of the frozen graph, valid as long
+ * as the graph is.
+ */
+CSRView ActorGraph::csrView() const {
+    CSRView view;
+    view.actorOffsets = actorOffsets;
+    view.actorMovies = actorMovies;
+    view.movieOffsets = movieOffsets;
+    view.movieActors = movieActors;
+    view.movieYear = movieYear;
+    view.movieWeight = movieWeight;
+    return view;
+}
 
-        // Create actor nodes (Note: Method prevents duplicates)
-        insertNode(actor_name);
+/* Replace actorMovies and movieActors with a compressed copy that
+ * BFS, BidirectionalBFS, Dijkstras and AStar decode as they search.
+ * A compressed graph can't be reordered, saved to a snapshot or
+ * have a contraction hierarchy or hub labels, and can't have them
+ * already either.
+ * Return true if the links were compressed, and false otherwise.
+ */
+bool ActorGraph::compressAdjacency() {
+    if(!frozen || compressed.isBuilt() || hierarchy.isBuilt() || hubLabels.isBuilt())
+        return false;
 
-        // Try finding the movie in map
-        try {
-            // Movie exists. 
-            // Add actor name to movie's list.
-            MovieActorList* malist = movie_map.at(to_string(movie_year) + movie_title);
-            (*malist).actorList.push_back(actor_name);
-        }
-        catch (const std::out_of_range& oor) {
-            // Movie doesn't exist. 
-            // Create new MovieActorList object with actor name in list.
-            MovieActorList* new_malist = new MovieActorList(movie_title, movie_year);
-            new_malist->actorList.push_back(actor_name);
-            movie_map.insert({to_string(movie_year) + movie_title, new_malist});
-        }
-    }
+    if(!compressed.build(csrView()))
+        return false;
+
+    // Release the plain links. A snapshot's stay mapped but are no
+    // longer read, so the kernel can drop their pages.
+    vector<uint32_t>().swap(storage.actorMovies);
+    vector<uint32_t>().swap(storage.movieActors);
+    actorMovies = ArrayView<uint32_t>();
+    movieActors = ArrayView<uint32_t>();
+
+    return true;
+}
+
+/* Return the number of bytes the actor-movie links take, including
+ * their offsets.
+ */
+size_t ActorGraph::adjacencyBytes() const {
+    if(compressed.isBuilt())
+        return compressed.sizeInBytes();
+    return (actorOffsets.size() + actorMovies.size() + movieOffsets.size()
+        + movieActors.size()) * sizeof(uint32_t);
+}
 
-    if (!infile.eof()) {
-        cerr << "Failed to read " << in_filename << "!\n";
+/* Run Breadth First Search on the graph, starting at src node.
+ * Only movies released in or before max_year are followed.
+ * Populate ws with path data as it runs.
+ * Return true if a path exists from src to dst, and false otherwise.
+ */
+bool ActorGraph::BFS(SearchWorkspace& ws, uint32_t src, uint32_t dst, int max_year) const {
+    // Without a dst there is nothing to search for
+    if(dst == NONE) {
+        ws.reset();
         return false;
     }
-    
-    infile.close();
 
-    // Add edges to graph using data from movie_map
-    for (auto pair : movie_map) {
-        MovieActorList* item = pair.second;
-        int num_actors = item->actorList.size();
+    return BFS(ws, src, vector<uint32_t>(1, dst), max_year) == 1;
+}
+
+/* Run Breadth First Search from src until every actor in targets
+ * has been reached, so one search answers many destinations.
+ * targets must be sorted and hold no duplicates. With no targets,
+ * every actor reachable from src is reached.
+ * Only movies released in or before max_year are followed.
+ * Populate ws with path data as it runs.
+ * Return the number of targets reached.
+ */
+size_t ActorGraph::BFS(SearchWorkspace& ws, uint32_t src, const vector<uint32_t>& targets,
+    int max_year) const {
+    if(!frozen)
+        return 0;
+
+    if(compressed.isBuilt())
+        return runBFS(compressed, ws, src, targets, max_year);
+    return runBFS(csrView(), ws, src, targets, max_year);
+}
+
+/* BFS over the neighbour lists of adj, either the CSR arrays or their
+ * compressed copy.
+ */
+template <typename Adjacency>
+size_t ActorGraph::runBFS(const Adjacency& adj, SearchWorkspace& ws, uint32_t src,
+    const vector<uint32_t>& targets, int max_year) const {
+    // Start a new search, actors and movies are reset as they're touched
+    ws.reset();
+
+    if(src == NONE)
+        return 0;
+
+    ws.touchActor(src);
+    ws.distance[src] = 0;
+
+    // Touch the targets so their path data can be read after the search
+    for(uint32_t target : targets)
+        ws.touchActor(target);
+
+    size_t reached = 0;
+
+    // BFS queue
+    queue<uint32_t> q;
+    q.push(src);
+
+    while(!q.empty()) {
+        uint32_t curr = q.front();
+        q.pop();
+
+        // For each movie curr starred in
+        for(uint32_t movie : adj.moviesOf(curr)) {
+
+            // A movie's cast was fully reached the first time it was expanded
+            ws.touchMovie(movie);
+            if(ws.movieDone[movie] || movieYear[movie] > max_year)
+                continue;
+            ws.movieDone[movie] = true;
+
+            // For each of curr's neighbour in that movie
+            for(uint32_t next : adj.castOf(movie)) {
+                ws.touchActor(next);
 
-        for (int i = 0; i < num_actors; i++) {
-            for(int j = i; j < num_actors; j++) {
-                int weight;
+                // If neighbour hasn't been visited
+                if(ws.distance[next] > ws.distance[curr] + 1) {
+                    // Neighbour distance = curr's distance + 1
+                    ws.distance[next] = ws.distance[curr] + 1;
 
-                if(use_weighted_edges)
-                    weight = 1 + (2015 - item->year);
-                else
-                    weight = 1;
+                    // Prev data = curr's data
+                    ws.prevNode[next] = curr;
+                    ws.prevMovie[next] = movie;
 
-                insertEdge(item->actorList[i], item->actorList[j], item->movie, item->year, weight);
+                    // If found every target node, terminate BFS
+                    if(binary_search(targets.begin(), targets.end(), next)
+                        && ++reached == targets.size())
+                        return reached;
+
+                    q.push(next);
+                }
             }
         }
-
-        // Delete MovieActorList object after finished adding edges for that movie
-        delete item;
     }
 
-    return true;
+    return reached;
 }
 
-/* Run Breadth First Search on the graph, starting at src node.
- * Populate nodes with path data as it runs.
- * Return true if a path exists from src to dst, and false otherwise.
+/* Expand one level of a bidirectional search from the actors in
+ * frontier, filling next with the actors reached for the first time.
+ * distance, prev and prevMovie are the state of the side being
+ * expanded, and otherDistance that of the opposite side. All are
+ * arrays of ws, whose actors and movies are touched as they're reached.
+ * Neighbours are read from adj.
+ * Return the actor where the two sides meet on the shortest path
+ * found in this level, or NONE if they haven't met.
  */
-bool ActorGraph::BFS(string src, string dst) {
-    // Set distance of all nodes to INT_MAX and reset prev data
-    for (auto item : nodes) {
-        item.second->distance = numeric_limits<int>::max();
-        item.second->prevNode = nullptr;
-        item.second->prevMovie = "";
-        item.second->prevYear = -1;
+template <typename Adjacency>
+uint32_t ActorGraph::expandLevel(const Adjacency& adj, SearchWorkspace& ws, const vector<uint32_t>& frontier,
+    vector<uint32_t>& next, vector<int>& distance, vector<uint32_t>& prev,
+    vector<uint32_t>& prevMovie, vector<bool>& movieDone, const vector<int>& otherDistance, int max_year) const {
+    uint32_t meet = NONE;
+    int meetLength = numeric_limits<int>::max();
+    next.clear();
+
+    for(uint32_t curr : frontier) {
+        for(uint32_t movie : adj.moviesOf(curr)) {
+
+            ws.touchMovie(movie);
+            if(movieDone[movie] || movieYear[movie] > max_year)
+                continue;
+            movieDone[movie] = true;
+
+            for(uint32_t actor : adj.castOf(movie)) {
+                ws.touchActor(actor);
+                if(distance[actor] != numeric_limits<int>::max())
+                    continue;
+
+                distance[actor] = distance[curr] + 1;
+                prev[actor] = curr;
+                prevMovie[actor] = movie;
+                next.push_back(actor);
+
+                // The sides meet where an actor is reached from both. Keep
+                // expanding the level, a later meeting may give a shorter path.
+                if(otherDistance[actor] != numeric_limits<int>::max()
+                    && distance[actor] + otherDistance[actor] < meetLength) {
+                    meet = actor;
+                    meetLength = distance[actor] + otherDistance[actor];
+                }
+            }
+        }
     }
 
-    auto srcNode = findNode(src);
-    if (!srcNode)
+    return meet;
+}
+
+/* Run Breadth First Search from both src and dst at once, always
+ * expanding the side with the smaller frontier by one level until
+ * the two sides meet. Finds a path as short as BFS does while
+ * reaching far fewer actors.
+ * Only movies released in or before max_year are followed.
+ * Populate ws with path data from src to dst as it runs.
+ * Return true if a path exists from src to dst, and false otherwise.
+ */
+bool ActorGraph::BidirectionalBFS(SearchWorkspace& ws, uint32_t src, uint32_t dst,
+    int max_year) const {
+    if(!frozen)
         return false;
 
-    srcNode->distance = 0;
+    if(compressed.isBuilt())
+        return runBidirectionalBFS(compressed, ws, src, dst, max_year);
+    return runBidirectionalBFS(csrView(), ws, src, dst, max_year);
+}
 
-    auto dstNode = findNode(dst);
-    if(!dstNode)
-        return false;
+/* BidirectionalBFS over the neighbour lists of adj, either the CSR
+ * arrays or their compressed copy.
+ */
+template <typename Adjacency>
+bool ActorGraph::runBidirectionalBFS(const Adjacency& adj, SearchWorkspace& ws, uint32_t src,
+    uint32_t dst, int max_year) const {
+    // Start a new search, actors and movies are reset as they're touched
+    ws.reset();
 
-    // BFS queue
-    queue<ActorNode*> q;
-    q.push(srcNode);
+    if(src == NONE)
+        return false;
 
-    while(!q.empty()) {
-        auto curr = q.front();
-        q.pop();
+    ws.touchActor(src);
+    ws.distance[src] = 0;
 
-        // For each of curr's neighbour: edge.nextNode
-        for(ActorEdge edge : curr->adjList) {
-            // If neighbour hasn't been visited
-            if(edge.nextNode->distance > curr->distance + 1) {
-                // Neighbour distance = curr's distance + 1
-                edge.nextNode->distance = curr->distance + 1;
+    // Like BFS, an actor has no path to itself
+    if(dst == NONE || src == dst)
+        return false;
 
-                // Prev data = curr's data
-                edge.nextNode->prevNode = curr;
-                edge.nextNode->prevMovie = edge.movie;
-                edge.nextNode->prevYear = edge.year;
+    ws.touchActor(dst);
+    ws.backDistance[dst] = 0;
+
+    vector<uint32_t> forward(1, src);
+    vector<uint32_t> backward(1, dst);
+    vector<uint32_t> next;
+
+    while(!forward.empty() && !backward.empty()) {
+        uint32_t meet;
+        if(forward.size() <= backward.size()) {
+            meet = expandLevel(adj, ws, forward, next, ws.distance, ws.prevNode, ws.prevMovie,
+                ws.movieDone, ws.backDistance, max_year);
+            forward.swap(next);
+        } else {
+            meet = expandLevel(adj, ws, backward, next, ws.backDistance, ws.nextNode, ws.nextMovie,
+                ws.backMovieDone, ws.distance, max_year);
+            backward.swap(next);
+        }
 
-                // If found dst node, terminate BFS
-                if(edge.nextNode == dstNode)
-                    return true;
+        if(meet == NONE)
+            continue;
 
-                q.push(edge.nextNode);
-            }
+        // Link the backward half of the path onto the forward half, so the
+        // prev data leads from dst back to src as after BFS
+        for(uint32_t curr = meet; curr != dst; curr = ws.nextNode[curr]) {
+            uint32_t following = ws.nextNode[curr];
+            ws.distance[following] = ws.distance[curr] + 1;
+            ws.prevNode[following] = curr;
+            ws.prevMovie[following] = ws.nextMovie[curr];
         }
+
+        return true;
     }
 
     return false;
 }
 
 /* Run Dijkstra's algorithm on the graph, starting at src node.
- * Populate nodes with path data as it runs.
+ * Populate ws with path data as it runs.
  * Return false if src or dst node doesn't exist.
  */
-bool ActorGraph::Dijkstras(string src, string dst) {
-    // Set distance of all nodes to INT_MAX and reset prev data 
-    for(auto item : nodes) {
-        item.second->distance = numeric_limits<int>::max();
-        item.second->prevNode = nullptr;
-        item.second->prevMovie = "";
-        item.second->prevYear = -1;
-        item.second->done = false;
+bool ActorGraph::Dijkstras(SearchWorkspace& ws, uint32_t src, uint32_t dst) const {
+    // Without a dst there is nothing to search for
+    if(dst == NONE) {
+        ws.reset();
+        return false;
+    }
+
+    Dijkstras(ws, src, vector<uint32_t>(1, dst));
+
+    // Always run on connected graph
+    return frozen && src != NONE;
+}
+
+/* Run Dijkstra's algorithm from src until every actor in targets
+ * has been settled, so one search answers many destinations.
+ * targets must be sorted and hold no duplicates. With no targets,
+ * every actor reachable from src is settled.
+ * Populate ws with path data as it runs.
+ * Return the number of targets settled.
+ */
+size_t ActorGraph::Dijkstras(SearchWorkspace& ws, uint32_t src, const vector<uint32_t>& targets) const {
+    if(!frozen)
+        return 0;
+
+    bool use_buckets = dijkstraQueue == BUCKET_QUEUE && minWeight >= 0;
+    if(compressed.isBuilt()) {
+        return use_buckets ? bucketDijkstras(compressed, ws, src, targets)
+            : heapDijkstras(compressed, ws, src, targets);
     }
+    return use_buckets ? bucketDijkstras(csrView(), ws, src, targets)
+        : heapDijkstras(csrView(), ws, src, targets);
+}
+
+/* Dijkstras on a binary heap ordered by distance, then actor name,
+ * over the neighbour lists of adj.
+ */
+template <typename Adjacency>
+size_t ActorGraph::heapDijkstras(const Adjacency& adj, SearchWorkspace& ws, uint32_t src,
+    const vector<uint32_t>& targets) const {
+    // Start a new search, actors and movies are reset as they're touched
+    ws.reset();
+
+    if(src == NONE)
+        return 0;
+
+    ws.touchActor(src);
+    ws.distance[src] = 0;
+
+    // Touch the targets so their path data can be read after the search
+    for(uint32_t target : targets)
+        ws.touchActor(target);
+
+    size_t settled = 0;
+
+    // Priority queue to store paths, ties are broken by actor name
+    priority_queue<pair<int, uint32_t>, vector<pair<int, uint32_t>>, ComparePathCost>
+        pq{ComparePathCost(&actors)};
+    pq.push(make_pair(0, src));
+
+    while(!pq.empty()) {
+        uint32_t curr = pq.top().second;
+        pq.pop();
+
+        if(!ws.done[curr]) {
+            ws.done[curr] = true;
+
+            // Paths to settled actors never change, stop once all targets are
+            if(binary_search(targets.begin(), targets.end(), curr)
+                && ++settled == targets.size())
+                break;
+
+            for(uint32_t movie : adj.moviesOf(curr)) {
+
+                // Actors are settled in order of distance, so a movie expanded
+                // by an earlier actor can't improve any of its cast
+                ws.touchMovie(movie);
+                if(ws.movieDone[movie])
+                    continue;
+                ws.movieDone[movie] = true;
+
+                int c = ws.distance[curr] + movieWeight[movie];
+
+                for(uint32_t next : adj.castOf(movie)) {
+                    ws.touchActor(next);
+
+                    // Update path details if this path thru curr is better
+                    if(c < ws.distance[next]) {
+                        ws.distance[next] = c;
+                        ws.prevNode[next] = curr;
+                        ws.prevMovie[next] = movie;
+
+                        pq.push(make_pair(c, next));
+                    }
+                }
+            }
+        }
+    }
+
+    return settled;
+}
+
+/* Dijkstras on a circular array of maxWeight + 1 buckets, one per
+ * distance, each a min-heap of actor IDs, over the neighbour lists of
+ * adj. Requires weights >= 0.
+ */
+template <typename Adjacency>
+size_t ActorGraph::bucketDijkstras(const Adjacency& adj, SearchWorkspace& ws, uint32_t src,
+    const vector<uint32_t>& targets) const {
+    // Start a new search, actors and movies are reset as they're touched
+    ws.reset();
+
+    if(src == NONE)
+        return 0;
+
+    ws.touchActor(src);
+    ws.distance[src] = 0;
+
+    // Touch the targets so their path data can be read after the search
+    for(uint32_t target : targets)
+        ws.touchActor(target);
+
+    size_t settled = 0;
+
+    // Every queued distance is within maxWeight of the current one, so
+    // distance d lives in bucket d % (maxWeight + 1)
+    size_t num_buckets = maxWeight + 1;
+    vector<vector<uint32_t>>& buckets = ws.buckets;
+    if(buckets.size() < num_buckets)
+        buckets.resize(num_buckets);
+    for(auto& bucket : buckets)
+        bucket.clear();
+
+    buckets[0].push_back(src);
+    size_t queued = 1;
+    int d = 0;
+
+    while(queued > 0) {
+        // Find the bucket of the next smallest queued distance
+        vector<uint32_t>* bucket = &buckets[d % num_buckets];
+        while(bucket->empty()) {
+            d++;
+            bucket = &buckets[d % num_buckets];
+        }
+
+        // Smallest actor ID first among actors of equal distance
+        pop_heap(bucket->begin(), bucket->end(), greater<uint32_t>());
+        uint32_t curr = bucket->back();
+        bucket->pop_back();
+        queued--;
+
+        // Skip actors already settled through a shorter path
+        if(ws.done[curr])
+            continue;
+        ws.done[curr] = true;
+
+        // Paths to settled actors never change, stop once all targets are
+        if(binary_search(targets.begin(), targets.end(), curr)
+            && ++settled == targets.size())
+            break;
+
+        for(uint32_t movie : adj.moviesOf(curr)) {
+
+            // Actors are settled in order of distance, so a movie expanded
+            // by an earlier actor can't improve any of its cast
+            ws.touchMovie(movie);
+            if(ws.movieDone[movie])
+                continue;
+            ws.movieDone[movie] = true;
+
+            int c = ws.distance[curr] + movieWeight[movie];
 
-    auto srcNode = findNode(src);
-    if (!srcNode)
+            for(uint32_t next : adj.castOf(movie)) {
+                ws.touchActor(next);
+
+                // Update path details if this path thru curr is better
+                if(c < ws.distance[next]) {
+                    ws.distance[next] = c;
+                    ws.prevNode[next] = curr;
+                    ws.prevMovie[next] = movie;
+
+                    vector<uint32_t>& target = buckets[c % num_buckets];
+                    target.push_back(next);
+                    push_heap(target.begin(), target.end(), greater<uint32_t>());
+                    queued++;
+                }
+            }
+        }
+    }
+
+    return settled;
+}
+
+/* Run A* search from src to dst, guided by lower bounds from the
+ * landmark index. Finds a path of the same cost as Dijkstras while
+ * settling far fewer actors. Without landmarks it runs as Dijkstras.
+ * Populate ws with path data as it runs.
+ * Return false if src or dst node doesn't exist.
+ */
+bool ActorGraph::AStar(SearchWorkspace& ws, uint32_t src, uint32_t dst) const {
+    if(!frozen)
         return false;
 
-    srcNode->distance = 0;
+    if(compressed.isBuilt())
+        return runAStar(compressed, ws, src, dst);
+    return runAStar(csrView(), ws, src, dst);
+}
+
+/* AStar over the neighbour lists of adj, either the CSR arrays or their
+ * compressed copy.
+ */
+template <typename Adjacency>
+bool ActorGraph::runAStar(const Adjacency& adj, SearchWorkspace& ws, uint32_t src,
+    uint32_t dst) const {
+    // Start a new search, actors and movies are reset as they're touched
+    ws.reset();
 
-    auto dstNode = findNode(dst);
-    if(!dstNode)
+    if(src == NONE)
         return false;
 
-    // Priority queue to store paths
-    priority_queue<pair<int, ActorNode*>, vector<pair<int, ActorNode*>>, ComparePathCost> pq;
-    pq.push(make_pair(srcNode->distance, srcNode));
+    ws.touchActor(src);
+    ws.distance[src] = 0;
+
+    if(dst == NONE)
+        return false;
+
+    ws.touchActor(dst);
+
+    // Like Dijkstras, an unreachable dst gives a path of dst alone
+    bool use_landmarks = landmarks.size() > 0;
+    if(use_landmarks && landmarks.separated(src, dst))
+        return true;
+
+    // Actors ordered by distance plus lower bound to dst, then by actor ID
+    priority_queue<pair<int, uint32_t>, vector<pair<int, uint32_t>>,
+        greater<pair<int, uint32_t>>> pq;
+    pq.push(make_pair(use_landmarks ? landmarks.lowerBound(src, dst) : 0, src));
 
     while(!pq.empty()) {
-        auto curr = pq.top();
+        uint32_t curr = pq.top().second;
         pq.pop();
 
-        if(!curr.second->done) {
-            curr.second->done = true;
-            for(ActorEdge edge : curr.second->adjList) {
-                int c = curr.second->distance + edge.weight;
+        if(ws.done[curr])
+            continue;
+        ws.done[curr] = true;
 
-                // Update path details if this path thru curr is better
-                if(c < edge.nextNode->distance) {
-                    edge.nextNode->distance = c;
-                    edge.nextNode->prevNode = curr.second;
-                    edge.nextNode->prevMovie = edge.movie;
-                    edge.nextNode->prevYear = edge.year;
+        if(curr == dst)
+            break;
+
+        for(uint32_t movie : adj.moviesOf(curr)) {
+            int c = ws.distance[curr] + movieWeight[movie];
+            ws.touchMovie(movie);
 
-                    pq.push(make_pair(c, edge.nextNode));
+            // Actors aren't settled in order of distance, so a movie can be
+            // expanded again when reached through a shorter path
+            if(c >= ws.movieDistance[movie])
+                continue;
+            ws.movieDistance[movie] = c;
+
+            for(uint32_t next : adj.castOf(movie)) {
+                ws.touchActor(next);
+
+                if(c < ws.distance[next]) {
+                    ws.distance[next] = c;
+                    ws.prevNode[next] = curr;
+                    ws.prevMovie[next] = movie;
+
+                    int bound = use_landmarks ? landmarks.lowerBound(next, dst) : 0;
+                    pq.push(make_pair(c + bound, next));
                 }
             }
         }
     }
 
-    // Always run on connected graph
     return true;
 }
 
-/* Run Dijkstras/BFS from src to dst and return the path string.
- * use_weighted_path = true -> Dijkstras
- * use_weighted_path = false -> BFS 
+/* Relabel the actors of the frozen graph in the order of strategy,
+ * so co-stars get nearby IDs and searches touch fewer cache lines.
+ * Every actor keeps its movies and every movie its cast in the same
+ * order, so BFS finds the same paths. Indexes are built on actor
+ * IDs, so the graph can't have any yet.
+ * Return true if the actors were relabeled, and false otherwise.
+ */
+bool ActorGraph::reorderActors(ActorOrdering::Strategy strategy) {
+    if(!frozen || compressed.isBuilt() || landmarks.size() > 0 || hierarchy.isBuilt() || hubLabels.isBuilt())
+        return false;
+
+    uint32_t num_actors = actors.size();
+    vector<uint32_t> new_id = ActorOrdering::compute(csrView(), strategy);
+    vector<uint32_t> old_id(num_actors);
+    for(uint32_t a = 0; a < num_actors; a++)
+        old_id[new_id[a]] = a;
+
+    // Move each actor's movies to its new ID
+    vector<uint32_t> offsets(num_actors + 1, 0);
+    vector<uint32_t> actor_movies;
+    actor_movies.reserve(actorMovies.size());
+    for(uint32_t a = 0; a < num_actors; a++) {
+        uint32_t old = old_id[a];
+        actor_movies.insert(actor_movies.end(), actorMovies.begin() + actorOffsets[old],
+            actorMovies.begin() + actorOffsets[old + 1]);
+        offsets[a + 1] = actor_movies.size();
+    }
+
+    // Rename the actors of each cast in place
+    vector<uint32_t> movie_actors(movieActors.size());
+    for(size_t j = 0; j < movieActors.size(); j++)
+        movie_actors[j] = new_id[movieActors[j]];
+
+    // The movie arrays don't change, and may still view a snapshot
+    storage.actorOffsets.swap(offsets);
+    storage.actorMovies.swap(actor_movies);
+    storage.movieActors.swap(movie_actors);
+    actorOffsets = storage.actorOffsets;
+    actorMovies = storage.actorMovies;
+    movieActors = storage.movieActors;
+
+    actors.permute(new_id);
+    computeComponents();
+
+    return true;
+}
+
+/* Build a landmark index of up to num_landmarks landmarks, after
+ * which weighted actorPath queries run AStar instead of Dijkstras.
+ * The index is saved in and loaded from snapshots with the graph.
+ * Return true if the index was built, and false otherwise.
+ */
+bool ActorGraph::buildLandmarks(unsigned num_landmarks) {
+    return landmarks.build(*this, num_landmarks);
+}
+
+/* Build a contraction hierarchy, after which weighted actorPath
+ * queries run on it instead of AStar or Dijkstras. Building may
+ * take minutes on a large graph. The hierarchy is saved in and
+ * loaded from snapshots with the graph.
+ * Return true if the hierarchy was built, and false otherwise.
+ */
+bool ActorGraph::buildHierarchy() {
+    return !compressed.isBuilt() && hierarchy.build(*this);
+}
+
+/* Build a hub label index with num_threads threads, after which
+ * unweighted actorPath queries are answered from the labels
+ * instead of BidirectionalBFS. The index is saved in and loaded
+ * from snapshots with the graph.
+ * Return true if the index was built, and false otherwise.
+ */
+bool ActorGraph::buildHubLabels(unsigned num_threads) {
+    return !compressed.isBuilt() && hubLabels.build(*this, num_threads);
+}
+
+/* Compute minWeight and maxWeight from the movie weights. */
+void ActorGraph::computeWeightRange() {
+    minWeight = 0;
+    maxWeight = 0;
+    for(int weight : movieWeight) {
+        minWeight = min(minWeight, weight);
+        maxWeight = max(maxWeight, weight);
+    }
+}
+
+/* Compute the connected component of every actor by uniting each
+ * movie's cast on a concurrent disjoint set, with the movies split
+ * over num_threads threads.
+ */
+void ActorGraph::computeComponents(unsigned num_threads) {
+    uint32_t num_actors = actors.size();
+    uint32_t num_movies = movies.size();
+
+    // Union each cast as a star around its first actor
+    ConcurrentDisjointSet sets(num_actors);
+    parallelRanges(num_threads, num_movies, [&](unsigned, size_t begin, size_t end) {
+        for(size_t m = begin; m < end; m++) {
+            for(uint32_t j = movieOffsets[m] + 1; j < movieOffsets[m + 1]; j++)
+                sets.unite(movieActors[movieOffsets[m]], movieActors[j]);
+        }
+    });
+
+    // Roots are the smallest actor ID of their set, so each root is
+    // numbered before the rest of its component
+    storage.actorComponent.resize(num_actors);
+    storage.componentSize.clear();
+    for(uint32_t a = 0; a < num_actors; a++) {
+        uint32_t root = sets.find(a);
+        if(root == a) {
+            storage.actorComponent[a] = storage.componentSize.size();
+            storage.componentSize.push_back(0);
+        } else {
+            storage.actorComponent[a] = storage.actorComponent[root];
+        }
+        storage.componentSize[storage.actorComponent[a]]++;
+    }
+
+    actorComponent = storage.actorComponent;
+    componentSize = storage.componentSize;
+}
+
+/* Return the number of connected components of each size. */
+map<uint32_t, uint32_t> ActorGraph::componentSizeDistribution() const {
+    map<uint32_t, uint32_t> distribution;
+    for(uint32_t size : componentSize)
+        distribution[size]++;
+    return distribution;
+}
+
+/* Return the path string ending at dst from path data in ws. */
+string ActorGraph::formatPath(const SearchWorkspace& ws, uint32_t dst) const {
+    string output = "";
+
+    // Push path data into stack starting from dst node
+    uint32_t curr = dst;
+    stack<string> path;
+    while(true) {
+        path.push("(" + string(actors.lookup(curr)) + ")");
+
+        uint32_t movie = ws.prevMovie[curr];
+        if(movie != NONE)
+            path.push("--[" + string(movies.title(movie)) + "#@" + to_string(movieYear[movie]) + "]-->");
+
+        if(ws.prevNode[curr] != NONE)
+            curr = ws.prevNode[curr];
+        else
+            break;
+    }
+
+    // Reverse stack content to get true path order
+    while(!path.empty()) {
+        output += path.top();
+        path.pop();
+    }
+
+    return output;
+}
+
+/* Return the path string through actors path[0 .. n), where
+ * pathMovies[i] is the movie shared by path[i] and path[i + 1].
  */
-string ActorGraph::actorPath(string src, string dst, bool use_weighted_path) {
+string ActorGraph::formatPath(const vector<uint32_t>& path, const vector<uint32_t>& pathMovies) const {
     string output = "";
+
+    for(size_t i = 0; i < path.size(); i++) {
+        if(i > 0) {
+            uint32_t movie = pathMovies[i - 1];
+            output += "--[" + string(movies.title(movie)) + "#@" + to_string(movieYear[movie]) + "]-->";
+        }
+        output += "(" + string(actors.lookup(path[i])) + ")";
+    }
+
+    return output;
+}
+
+/* Run Dijkstras/BFS from src to dst and return the path string.
+ * Actors in different components have no path, and are answered
+ * without searching.
+ * use_weighted_path = true -> contraction hierarchy if built,
+ *     AStar with landmarks, Dijkstras otherwise
+ * use_weighted_path = false -> hub labels if built,
+ *     BidirectionalBFS otherwise
+ * ws holds the search state, so queries with different workspaces
+ * can run concurrently.
+ */
+string ActorGraph::actorPath(SearchWorkspace& ws, const string& src, const string& dst,
+    bool use_weighted_path) const {
     bool succeed;
 
+    uint32_t srcId = findNode(src);
+    uint32_t dstId = findNode(dst);
+
+    if(frozen && srcId != NONE && dstId != NONE && componentOf(srcId) != componentOf(dstId))
+        return "Path from " + src + " to " + dst + " doesn't exist.";
+
+    if(use_weighted_path && hierarchy.isBuilt()) {
+        vector<uint32_t> path, pathMovies;
+        if(hierarchy.query(ws, srcId, dstId, path, pathMovies))
+            return formatPath(path, pathMovies);
+        else
+            return "Path from " + src + " to " + dst + " doesn't exist.";
+    }
+
+    if(!use_weighted_path && hubLabels.isBuilt()) {
+        vector<uint32_t> path, pathMovies;
+        if(hubLabels.path(csrView(), srcId, dstId, path, pathMovies))
+            return formatPath(path, pathMovies);
+        else
+            return "Path from " + src + " to " + dst + " doesn't exist.";
+    }
+
     // Run pathfinding algorithm on graph
-    if(use_weighted_path)
-        succeed = Dijkstras(src, dst);
+    if(use_weighted_path && landmarks.size() > 0)
+        succeed = AStar(ws, srcId, dstId);
+    else if(use_weighted_path)
+        succeed = Dijkstras(ws, srcId, dstId);
     else
-        succeed = BFS(src, dst);
+        succeed = BidirectionalBFS(ws, srcId, dstId);
 
-    // If pathfinding succeeded, push path data into stack starting from dst node
-    if(succeed) {
-        auto curr = findNode(dst);
-        stack<string> path;
-        while(true) {
-            path.push("(" + curr->name + ")");
+    if(succeed)
+        return formatPath(ws, dstId);
+    else
+        return "Path from " + src + " to " + dst + " doesn't exist.";
+}
 
-            if(curr->prevMovie != "")
-                path.push("--[" + curr->prevMovie + "#@" + to_string(curr->prevYear) + "]-->");
+/* Run actorPath with a workspace allocated for this query only. */
+string ActorGraph::actorPath(const string& src, const string& dst, bool use_weighted_path) const {
+    SearchWorkspace ws(*this);
+    return actorPath(ws, src, dst, use_weighted_path);
+}
 
-            if(curr->prevNode)
-                curr = curr->prevNode;
-            else
-                break;
-        }
+/* Write the frozen graph, its actor and movie tables and its weights
+ * to a binary snapshot file.
+ * Return true if the snapshot was written successfully, and false otherwise.
+ */
+bool ActorGraph::saveSnapshot(const char* out_filename) const {
+    if(!frozen)
+        return false;
 
-        // Reverse stack content to get true path order
-        while(!path.empty()) {
-            output += path.top();
-            path.pop();
-        }
-    } else {
-        output = "Path from " + src + " to " + dst + " doesn't exist.";
+    if(compressed.isBuilt()) {
+        cerr << "Can't save a graph with compressed links to " << out_filename << "!\n";
+        return false;
     }
 
-    return output;
+    vector<char> nameChars, titleChars;
+    vector<uint32_t> nameOffsets, nameOrder, titleOffsets, movieOrder;
+    vector<int> years;
+    actors.flatten(nameChars, nameOffsets, nameOrder);
+    movies.flatten(titleChars, titleOffsets, years, movieOrder);
+
+    SnapshotWriter writer(weighted ? SNAPSHOT_WEIGHTED : 0);
+    writer.addSection(SECTION_ACTOR_OFFSETS, actorOffsets);
+    writer.addSection(SECTION_ACTOR_MOVIES, actorMovies);
+    writer.addSection(SECTION_MOVIE_OFFSETS, movieOffsets);
+    writer.addSection(SECTION_MOVIE_ACTORS, movieActors);
+    writer.addSection(SECTION_MOVIE_YEARS, movieYear);
+    writer.addSection(SECTION_MOVIE_WEIGHTS, movieWeight);
+    writer.addSection(SECTION_ACTOR_NAME_CHARS, ArrayView<char>(nameChars));
+    writer.addSection(SECTION_ACTOR_NAME_OFFSETS, ArrayView<uint32_t>(nameOffsets));
+    writer.addSection(SECTION_ACTOR_NAME_ORDER, ArrayView<uint32_t>(nameOrder));
+    writer.addSection(SECTION_MOVIE_TITLE_CHARS, ArrayView<char>(titleChars));
+    writer.addSection(SECTION_MOVIE_TITLE_OFFSETS, ArrayView<uint32_t>(titleOffsets));
+    writer.addSection(SECTION_MOVIE_ORDER, ArrayView<uint32_t>(movieOrder));
+    writer.addSection(SECTION_ACTOR_COMPONENTS, actorComponent);
+    writer.addSection(SECTION_COMPONENT_SIZES, componentSize);
+    if(landmarks.size() > 0) {
+        writer.addSection(SECTION_LANDMARKS, landmarks.landmarkArray());
+        writer.addSection(SECTION_LANDMARK_DISTANCES, landmarks.distanceArray());
+    }
+    if(hierarchy.isBuilt()) {
+        writer.addSection(SECTION_HIERARCHY_OFFSETS, hierarchy.offsetArray());
+        writer.addSection(SECTION_HIERARCHY_TARGETS, hierarchy.targetArray());
+        writer.addSection(SECTION_HIERARCHY_WEIGHTS, hierarchy.weightArray());
+        writer.addSection(SECTION_HIERARCHY_MIDDLES, hierarchy.middleArray());
+    }
+    if(hubLabels.isBuilt()) {
+        writer.addSection(SECTION_LABEL_OFFSETS, hubLabels.offsetArray());
+        writer.addSection(SECTION_LABEL_HUBS, hubLabels.hubArray());
+        writer.addSection(SECTION_LABEL_DISTANCES, hubLabels.distanceArray());
+    }
+
+    if(!writer.write(out_filename)) {
+        cerr << "Failed to write " << out_filename << "!\n";
+        return false;
+    }
+    return true;
 }
 
-/* Prepare the graph for actorconnections algorithm by
- * creating nodes with no edges for all actors and 
- * return pointer to a map containing movie->actors data.
- */
-map<string, MovieActorList*>* ActorGraph::prepActorConnections(const char* in_filename) {
-    // Initialize the file stream
-    ifstream infile(in_filename);
-
-    bool have_header = false;
-    
-    // Create an ordered map to store movies and list of actors in that movie
-    // Key = to_string(movie_year) + movie_title (so keys are ordered by year)
-    map<string, MovieActorList*>* movie_map = new map<string, MovieActorList*>;
-    
-    // Keep reading lines until the end of file is reached
-    while(infile) {
-        string s;
-        if (!getline(infile, s)) break;
-        if (!have_header) {
-            have_header = true;
-            continue;
-        }
-        istringstream ss(s);
-        vector<string> record;
-        while(ss) {
-            string next;
-            if (!getline(ss, next, '\t'))
-                break;
-            record.push_back(next);
-        }
-        if(record.size() != 3) {
+/* Load the graph from a snapshot written by saveSnapshot. The file is
+ * mapped read-only and used in place, so the graph can be queried
+ * without parsing or building anything. The graph must be empty.
+ * Return true if the snapshot was loaded successfully, and false otherwise.
+ */
+bool ActorGraph::loadSnapshot(const char* in_filename) {
+    if(frozen || actors.size() > 0 || movies.size() > 0)
+        return false;
+
+    shared_ptr<SnapshotFile> file = make_shared<SnapshotFile>();
+    if(!file->open(in_filename)) {
+        cerr << "Failed to read snapshot " << in_filename << "!\n";
+        return false;
+    }
+
+    // The tables and arrays below point into the mapping, keep it alive
+    snapshot = file;
+
+    ArrayView<char> nameChars, titleChars;
+    ArrayView<uint32_t> nameOffsets, nameOrder, titleOffsets, movieOrder;
+
+    bool ok = file->section(SECTION_ACTOR_OFFSETS, actorOffsets)
+        && file->section(SECTION_ACTOR_MOVIES, actorMovies)
+        && file->section(SECTION_MOVIE_OFFSETS, movieOffsets)
+        && file->section(SECTION_MOVIE_ACTORS, movieActors)
+        && file->section(SECTION_MOVIE_YEARS, movieYear)
+        && file->section(SECTION_MOVIE_WEIGHTS, movieWeight)
+        && file->section(SECTION_ACTOR_NAME_CHARS, nameChars)
+        && file->section(SECTION_ACTOR_NAME_OFFSETS, nameOffsets)
+        && file->section(SECTION_ACTOR_NAME_ORDER, nameOrder)
+        && file->section(SECTION_MOVIE_TITLE_CHARS, titleChars)
+        && file->section(SECTION_MOVIE_TITLE_OFFSETS, titleOffsets)
+        && file->section(SECTION_MOVIE_ORDER, movieOrder)
+        && actors.attach(nameChars, nameOffsets, nameOrder)
+        && movies.attach(titleChars, titleOffsets, movieYear, movieOrder);
+
+    // The CSR arrays must agree with the tables and with each other
+    ok = ok && actorOffsets.size() == actors.size() + 1
+        && movieOffsets.size() == movies.size() + 1
+        && movieWeight.size() == movies.size()
+        && actorOffsets[actors.size()] == actorMovies.size()
+        && movieOffsets[movies.size()] == movieActors.size();
+
+    // Every offset and ID must stay in range, so searches can't read
+    // outside the arrays
+    for(uint32_t a = 0; ok && a < actors.size(); a++)
+        ok = actorOffsets[a] <= actorOffsets[a + 1];
+    for(uint32_t m = 0; ok && m < movies.size(); m++)
+        ok = movieOffsets[m] <= movieOffsets[m + 1];
+    for(size_t i = 0; ok && i < actorMovies.size(); i++)
+        ok = actorMovies[i] < movies.size();
+    for(size_t j = 0; ok && j < movieActors.size(); j++)
+        ok = movieActors[j] < actors.size();
+
+    // Snapshots written before components were saved have them recomputed
+    if(ok && file->section(SECTION_ACTOR_COMPONENTS, actorComponent)) {
+        ok = file->section(SECTION_COMPONENT_SIZES, componentSize)
+            && actorComponent.size() == actors.size();
+        for(uint32_t a = 0; ok && a < actorComponent.size(); a++)
+            ok = actorComponent[a] < componentSize.size();
+    } else if(ok) {
+        computeComponents();
+    }
+
+    // The landmark index is optional
+    ArrayView<uint32_t> landmarkIds;
+    ArrayView<int> landmarkDistances;
+    if(ok && file->section(SECTION_LANDMARKS, landmarkIds)) {
+        ok = file->section(SECTION_LANDMARK_DISTANCES, landmarkDistances)
+            && landmarks.attach(landmarkIds, landmarkDistances, actors.size());
+    }
+
+    // So is the contraction hierarchy
+    ArrayView<uint32_t> upOffsets, upTargets, upMiddles;
+    ArrayView<int> upWeights;
+    if(ok && file->section(SECTION_HIERARCHY_OFFSETS, upOffsets)) {
+        ok = file->section(SECTION_HIERARCHY_TARGETS, upTargets)
+            && file->section(SECTION_HIERARCHY_WEIGHTS, upWeights)
+            && file->section(SECTION_HIERARCHY_MIDDLES, upMiddles)
+            && hierarchy.attach(upOffsets, upTargets, upWeights, upMiddles,
+                actors.size(), movies.size());
+    }
+
+    // And the hub labels
+    ArrayView<uint32_t> labelOffsets, labelHubs;
+    ArrayView<uint8_t> labelDistances;
+    if(ok && file->section(SECTION_LABEL_OFFSETS, labelOffsets)) {
+        ok = file->section(SECTION_LABEL_HUBS, labelHubs)
+            && file->section(SECTION_LABEL_DISTANCES, labelDistances)
+            && hubLabels.attach(labelOffsets, labelHubs, labelDistances, actors.size());
+    }
+
+    if(!ok) {
+        cerr << "Invalid snapshot " << in_filename << "!\n";
+        return false;
+    }
+
+    weighted = (snapshot->flags() & SNAPSHOT_WEIGHTED) != 0;
+    computeWeightRange();
+    frozen = true;
+
+    return true;
+}
+
+/* Return pointer to a list of movie->actors data of the frozen graph,
+ * ordered by year, then by title.
+ */
+vector<MovieActorList>* ActorGraph::movieList() const {
+    vector<MovieActorList>* movie_list = new vector<MovieActorList>;
+    if(!frozen)
+        return movie_list;
+
+    for(uint32_t m = 0; m < movies.size(); m++) {
+        if(movieOffsets[m] == movieOffsets[m + 1])
             continue;
-        }
-     
-        string actor_name(record[0]);
-        string movie_title(record[1]);
-        int movie_year = stoi(record[2]);
-     
-        // Create actor nodes (Note: Method prevents duplicates)   
-        insertNode(actor_name);
-        
-        // Try finding the movie in map
-        try {
-            // Movie exists. 
-            // Add actor name to movie's list.
-            MovieActorList* malist = (*movie_map).at(to_string(movie_year) + movie_title);
-            (*malist).actorList.push_back(actor_name);
-        } catch (const std::out_of_range& oor) {
-            // Movie doesn't exist. 
-            // Create new MovieActorList object with actor name in list.
-            MovieActorList* new_malist = new MovieActorList(movie_title, movie_year);
-            new_malist->actorList.push_back(actor_name);
-            (*movie_map).insert({to_string(movie_year) + movie_title, new_malist});
+
+        movie_list->push_back(MovieActorList(m, movieYear[m]));
+        vector<uint32_t>& cast = movie_list->back().actorList;
+        if(compressed.isBuilt()) {
+            for(uint32_t actor : compressed.castOf(m))
+                cast.push_back(actor);
+        } else {
+            cast.assign(movieActors.begin() + movieOffsets[m], movieActors.begin() + movieOffsets[m + 1]);
         }
     }
 
-    if (!infile.eof()) {
-        cerr << "Failed to read " << in_filename << "!\n";
-        return nullptr;
-    }
-    infile.close();
+    // Order movies by year, then by title
+    sort(movie_list->begin(), movie_list->end(),
+        [this](const MovieActorList& a, const MovieActorList& b) {
+            if(a.year != b.year)
+                return a.year < b.year;
+            return movies.title(a.movie) < movies.title(b.movie);
+        });
 
-    return movie_map;
+    return movie_list;
 }
 
-/* Run actorconnections algorithm on list of src and dst pairs.
- * Use movie data map returned from prepActorConnections.
+/* Run actorconnections algorithm on list of src and dst pairs
+ * over the frozen graph.
  * Return vector of actorconnections data for each input pair.
  */
-vector<string> ActorGraph::actorConnections(map<string, MovieActorList*>* movie_map, vector<string> src, vector<string> dst) {
-    // Clear edges for all nodes
-    for (auto item : nodes)
-        item.second->adjList.clear();
+vector<string> ActorGraph::actorConnections(const vector<string>& src, const vector<string>& dst) const {
+    if(!frozen)
+        return vector<string>();
+
+    SearchWorkspace ws(*this);
+
+    // Distinct release years of the movies in the graph. BFS at each year
+    // boundary only follows movies released up to that year.
+    vector<int> years;
+    for(uint32_t m = 0; m < movies.size(); m++) {
+        if(movieOffsets[m] != movieOffsets[m + 1])
+            years.push_back(movieYear[m]);
+    }
+    sort(years.begin(), years.end());
+    years.erase(unique(years.begin(), years.end()), years.end());
 
     // Starting year of our movie data set
     int prev_y;
-    if((*movie_map).begin() == (*movie_map).end())
+    if(years.empty())
         prev_y = 9999;
     else
-        prev_y = (*movie_map).begin()->second->year;
+        prev_y = years.front();
 
     vector<string> output;  // Vector to store output of each pair
     vector<bool> done;      // Vector to store status of each pair
+    vector<uint32_t> srcIds;
+    vector<uint32_t> dstIds;
     int num_pairs = src.size();
 
     for(int i = 0; i < num_pairs; i++) {
         output.push_back(src[i] + '\t' + dst[i] + '\t');
         done.push_back(false);
+        srcIds.push_back(findNode(src[i]));
+        dstIds.push_back(findNode(dst[i]));
     }
 
-    // For each movie
-    for(auto pair : *movie_map) {
-        MovieActorList* item = pair.second;
-        int num_actors = item->actorList.size();
-        int y = item->year;
-
-        // If this movie's year != prev movie's year, run BFS for each undone pair
+    // For each year after the first, run BFS for each undone pair
+    for(int y : years) {
         if(prev_y != y) {
             for(int i = 0; i < num_pairs; i++) {
                 if(!done[i]) {
-                    bool connected = BFS(src[i], dst[i]);
+                    bool connected = BidirectionalBFS(ws, srcIds[i], dstIds[i], prev_y);
                     if(connected) {
                         output[i] += to_string(prev_y);
                         done[i] = true;
@@ -445,19 +1238,12 @@ vector<string> ActorGraph::actorConnections(map<string, MovieActorList*>* movie_
 
             prev_y = y;
         }
-
-        // Add edges for this movie
-        for(int i = 0; i < num_actors; i++) {
-            for(int j = i; j < num_actors; j++) {
-                insertEdge(item->actorList[i], item->actorList[j], item->movie, item->year, 1);
-            }
-        }
     }
 
     // Run BFS for all undone pairs again, in case all movies are from the same year
     for(int i = 0; i < num_pairs; i++) {
         if(!done[i]) {
-            bool connected = BFS(src[i], dst[i]);
+            bool connected = BidirectionalBFS(ws, srcIds[i], dstIds[i], prev_y);
             if(connected)
                 output[i] += to_string(prev_y);
             else
@@ -467,9 +1253,3 @@ vector<string> ActorGraph::actorConnections(map<string, MovieActorList*>* movie_
 
     return output;
 }
-
-/* Destructor */
-ActorGraph::~ActorGraph() {
-    for(auto item : nodes)
-        delete item.second;
-}
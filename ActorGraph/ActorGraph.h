@@ -9,46 +9,202 @@
 #include <unordered_map>
 #include <vector>
 #include <map>
-#include "ActorNode.h"
-#include "ActorEdge.h"
+#include <limits>
+#include <cstdint>
+#include <memory>
+#include "ActorOrdering.h"
+#include "ArrayView.h"
+#include "CSRView.h"
+#include "CompressedAdjacency.h"
+#include "GraphSnapshot.h"
+#include "HubLabelIndex.h"
+#include "LandmarkIndex.h"
+#include "ContractionHierarchy.h"
 #include "MovieActorList.h"
+#include "SearchWorkspace.h"
+#include "StringTable.h"
 
 using namespace std;
 
 class ActorGraph {
     private:
-        /* Hash map storing the nodes of the graph. 
-         * Key = Actor name.
-         * Value = Pointer to that actor's node.
+        /* Interned actor names and movies.
+         * Actor and movie IDs index every other per-actor and per-movie array.
          */
-        unordered_map<string, ActorNode*> nodes;
+        StringTable actors;
+        MovieTable movies;
+
+        /* Movies inserted so far with their cast and edge weight, in
+         * insertion order. Released when the graph is frozen.
+         */
+        vector<MovieActorList> castLists;
+        vector<int> castWeights; // Indexed by movie ID
+        static const int NO_WEIGHT = numeric_limits<int>::min();
+
+        /* Frozen bipartite actor-movie graph in compressed sparse row (CSR)
+         * form. Actor i starred in movies actorMovies[actorOffsets[i] ..
+         * actorOffsets[i + 1]), in movie insertion order. Movie m's cast is
+         * movieActors[movieOffsets[m] .. movieOffsets[m + 1]), in cast file
+         * order. The weight of a path is charged on each movie hop.
+         */
+        bool frozen;
+        bool weighted;
+        ArrayView<uint32_t> actorOffsets;
+        ArrayView<uint32_t> actorMovies;
+        ArrayView<uint32_t> movieOffsets;
+        ArrayView<uint32_t> movieActors;
+        ArrayView<int> movieYear;
+        ArrayView<int> movieWeight;
+
+        /* Storage behind the CSR arrays. A graph frozen in memory owns its
+         * arrays in storage, while a graph loaded from a snapshot views the
+         * mapped snapshot file instead.
+         */
+        struct CSRStorage {
+            vector<uint32_t> actorOffsets;
+            vector<uint32_t> actorMovies;
+            vector<uint32_t> movieOffsets;
+            vector<uint32_t> movieActors;
+            vector<int> movieYear;
+            vector<int> movieWeight;
+            vector<uint32_t> actorComponent;
+            vector<uint32_t> componentSize;
+        } storage;
+        shared_ptr<SnapshotFile> snapshot;
+
+        /* Connected component of each actor, numbered in order of their
+         * smallest actor ID, and the number of actors in each component.
+         * Computed when the graph is frozen, so actors in different
+         * components are known to have no path without searching.
+         */
+        ArrayView<uint32_t> actorComponent;
+        ArrayView<uint32_t> componentSize;
+
+        /* Optional compressed copy of actorMovies and movieActors. Once
+         * built, searches read it and the plain arrays are released.
+         */
+        CompressedAdjacency compressed;
+
+        /* Optional landmark distances used by AStar */
+        LandmarkIndex landmarks;
+
+        /* Optional contraction hierarchy for weighted queries */
+        ContractionHierarchy hierarchy;
+
+        /* Optional hub labels for unweighted queries */
+        HubLabelIndex hubLabels;
+
+        /* Range of the movie weights, set when the graph is frozen */
+        int minWeight;
+        int maxWeight;
+
+    public:
+        /* Priority queues Dijkstras can run on */
+        enum DijkstraQueue {
+            HEAP_QUEUE,    // Binary heap, ties broken by actor name
+            BUCKET_QUEUE   // Bucket per distance, ties broken by actor ID
+        };
+
+    private:
+        DijkstraQueue dijkstraQueue;
+
+        /* Compute minWeight and maxWeight from the movie weights. */
+        void computeWeightRange();
+
+        /* Compute the connected component of every actor by uniting each
+         * movie's cast on a concurrent disjoint set, with the movies split
+         * over num_threads threads.
+         */
+        void computeComponents(unsigned num_threads = 1);
+
+        /* BFS over the neighbour lists of adj, either the CSR arrays or their
+         * compressed copy.
+         */
+        template <typename Adjacency>
+        size_t runBFS(const Adjacency& adj, SearchWorkspace& ws, uint32_t src,
+            const vector<uint32_t>& targets, int max_year) const;
+
+        /* BidirectionalBFS over the neighbour lists of adj, either the CSR
+         * arrays or their compressed copy.
+         */
+        template <typename Adjacency>
+        bool runBidirectionalBFS(const Adjacency& adj, SearchWorkspace& ws, uint32_t src,
+            uint32_t dst, int max_year) const;
+
+        /* AStar over the neighbour lists of adj, either the CSR arrays or their
+         * compressed copy.
+         */
+        template <typename Adjacency>
+        bool runAStar(const Adjacency& adj, SearchWorkspace& ws, uint32_t src,
+            uint32_t dst) const;
+
+        /* Dijkstras on a binary heap ordered by distance, then actor name,
+         * over the neighbour lists of adj.
+         */
+        template <typename Adjacency>
+        size_t heapDijkstras(const Adjacency& adj, SearchWorkspace& ws, uint32_t src,
+            const vector<uint32_t>& targets) const;
+
+        /* Dijkstras on a circular array of maxWeight + 1 buckets, one per
+         * distance, each a min-heap of actor IDs, over the neighbour lists of
+         * adj. Requires weights >= 0.
+         */
+        template <typename Adjacency>
+        size_t bucketDijkstras(const Adjacency& adj, SearchWorkspace& ws, uint32_t src,
+            const vector<uint32_t>& targets) const;
+
+        /* Expand one level of a bidirectional search from the actors in
+         * frontier, filling next with the actors reached for the first time.
+         * distance, prev and prevMovie are the state of the side being
+         * expanded, and otherDistance that of the opposite side. All are
+         * arrays of ws, whose actors and movies are touched as they're reached.
+         * Neighbours are read from adj.
+         * Return the actor where the two sides meet on the shortest path
+         * found in this level, or NONE if they haven't met.
+         */
+        template <typename Adjacency>
+        uint32_t expandLevel(const Adjacency& adj, SearchWorkspace& ws, const vector<uint32_t>& frontier,
+            vector<uint32_t>& next, vector<int>& distance, vector<uint32_t>& prev,
+            vector<uint32_t>& prevMovie, vector<bool>& movieDone, const vector<int>& otherDistance, int max_year) const;
 
     public:
+        /* Marks a missing actor or movie ID */
+        static const uint32_t NONE = StringTable::NONE;
+
         /* Constructor */
-        ActorGraph() {}
+        ActorGraph() : frozen(false), weighted(false), minWeight(0), maxWeight(0),
+            dijkstraQueue(BUCKET_QUEUE) {}
 
         /* Insert node to graph.
          * Return true if node was inserted successfully, and false otherwise.
-         * Inserting duplicate actor is not allowed.
+         * Inserting duplicate actor or inserting into a frozen graph is not allowed.
          */
-        bool insertNode(string actorName);
+        bool insertNode(const string& actorName);
 
         /* Find the node with input actorName.
-         * Return pointer to the node if found.
-         * Return nullpointer if not found.
+         * Return the actor ID of the node if found.
+         * Return NONE if not found.
          */
-        ActorNode* findNode(string actorName);
+        uint32_t findNode(const string& actorName) const;
 
-        /* Insert an undirected edge to graph.
-         * Return true if edge was inserted successfully, and false otherwise.
-         */
-        bool insertEdge(string src, string dst, string movie, int year, int weight);
+        /* Return the name of the actor with the given ID. */
+        string_view actorName(uint32_t id) const { return actors.lookup(id); }
 
-        /* Insert a directed edge to graph.
-         * Return true if edge was inserted successfully, and false otherwise.
-         * Self-loop is not allowed.
+        /* Return the table of interned actor names. */
+        const StringTable& actorTable() const { return actors; }
+
+        /* Return the number of actors in the graph. */
+        uint32_t numActors() const { return actors.size(); }
+
+        /* Return the number of movies in the graph. */
+        uint32_t numMovies() const { return movies.size(); }
+
+        /* Insert a movie and its cast, connecting every pair of its actors.
+         * Paths through the movie cost weight.
+         * Return true if movie was inserted successfully, and false otherwise.
+         * Inserting a movie twice or inserting into a frozen graph is not allowed.
          */
-        bool insertDirectedEdge(string src, string dst, string movie, int year, int weight);
+        bool insertMovie(const MovieActorList& item, int weight);
 
         /* Load the graph from a tab-delimited file of actor->movie relationships.
          *
@@ -56,44 +212,222 @@ class ActorGraph {
          * use_weighted_edges - 
          *     if true, compute edge weights as 1 + (2015 - movie_year), 
          *     otherwise all edge weights will be 1
+         * num_threads - number of threads used to parse the file and build the graph
          *
          * Return true if file was loaded sucessfully, and false otherwise.
          */
-        bool loadFromFile(const char* in_filename, bool use_weighted_edges);
+        bool loadFromFile(const char* in_filename, bool use_weighted_edges,
+            unsigned num_threads = 1);
+
+        /* Compact the inserted movies into the CSR arrays and release the
+         * cast lists. No nodes or movies can be inserted afterwards.
+         * With num_threads > 1, the arrays are counted and filled in parallel
+         * over ranges of movies. The result is identical to a single-threaded
+         * freeze. The graph is immutable once frozen, and only frozen graphs
+         * can be searched.
+         */
+        void freeze(unsigned num_threads = 1);
+
+        /* Return a view of the CSR arrays of the frozen graph, valid as long
+         * as the graph is. actorMovies and movieActors are empty once the
+         * links are compressed.
+         */
+        CSRView csrView() const;
+
+        /* Replace actorMovies and movieActors with a compressed copy that
+         * BFS, BidirectionalBFS, Dijkstras and AStar decode as they search.
+         * A compressed graph can't be reordered, saved to a snapshot or
+         * have a contraction hierarchy or hub labels, and can't have them
+         * already either.
+         * Return true if the links were compressed, and false otherwise.
+         */
+        bool compressAdjacency();
+
+        /* Return true if the links of the graph are compressed. */
+        bool isCompressed() const { return compressed.isBuilt(); }
+
+        /* Return the number of bytes the actor-movie links take, including
+         * their offsets.
+         */
+        size_t adjacencyBytes() const;
+
+        /* Return true if the graph has been frozen into CSR form. */
+        bool isFrozen() const { return frozen; }
+
+        /* Return true if movie weights are 1 + (2015 - movie_year). */
+        bool isWeighted() const { return weighted; }
+
+        /* Write the frozen graph, its actor and movie tables and its weights
+         * to a binary snapshot file.
+         * Return true if the snapshot was written successfully, and false otherwise.
+         */
+        bool saveSnapshot(const char* out_filename) const;
+
+        /* Load the graph from a snapshot written by saveSnapshot. The file is
+         * mapped read-only and used in place, so the graph can be queried
+         * without parsing or building anything. The graph must be empty.
+         * Return true if the snapshot was loaded successfully, and false otherwise.
+         */
+        bool loadSnapshot(const char* in_filename);
+
+        /* Return pointer to a list of movie->actors data of the frozen graph,
+         * ordered by year, then by title.
+         */
+        vector<MovieActorList>* movieList() const;
 
         /* Run Breadth First Search on the graph, starting at src node.
-         * Populate nodes with path data as it runs.
+         * Only movies released in or before max_year are followed.
+         * Populate ws with path data as it runs.
+         * Return true if a path exists from src to dst, and false otherwise.
+         */
+        bool BFS(SearchWorkspace& ws, uint32_t src, uint32_t dst,
+            int max_year = numeric_limits<int>::max()) const;
+
+        /* Run Breadth First Search from both src and dst at once, always
+         * expanding the side with the smaller frontier by one level until
+         * the two sides meet. Finds a path as short as BFS does while
+         * reaching far fewer actors.
+         * Only movies released in or before max_year are followed.
+         * Populate ws with path data from src to dst as it runs.
          * Return true if a path exists from src to dst, and false otherwise.
          */
-        bool BFS(string src, string dst);
+        bool BidirectionalBFS(SearchWorkspace& ws, uint32_t src, uint32_t dst,
+            int max_year = numeric_limits<int>::max()) const;
+
+        /* Return the connected component of an existing actor of the frozen
+         * graph. Two actors have a path between them only if they are in
+         * the same component.
+         */
+        uint32_t componentOf(uint32_t actor) const { return actorComponent[actor]; }
+
+        /* Return the number of connected components of the frozen graph. */
+        uint32_t numComponents() const { return componentSize.size(); }
+
+        /* Return the number of actors in each connected component, indexed
+         * by component.
+         */
+        ArrayView<uint32_t> componentSizes() const { return componentSize; }
+
+        /* Return the number of connected components of each size. */
+        map<uint32_t, uint32_t> componentSizeDistribution() const;
+
+        /* Relabel the actors of the frozen graph in the order of strategy,
+         * so co-stars get nearby IDs and searches touch fewer cache lines.
+         * Every actor keeps its movies and every movie its cast in the same
+         * order, so BFS finds the same paths. Indexes are built on actor
+         * IDs, so the graph can't have any yet.
+         * Return true if the actors were relabeled, and false otherwise.
+         */
+        bool reorderActors(ActorOrdering::Strategy strategy);
+
+        /* Build a landmark index of up to num_landmarks landmarks, after
+         * which weighted actorPath queries run AStar instead of Dijkstras.
+         * The index is saved in and loaded from snapshots with the graph.
+         * Return true if the index was built, and false otherwise.
+         */
+        bool buildLandmarks(unsigned num_landmarks);
+
+        /* Return the number of landmarks in the landmark index. */
+        uint32_t numLandmarks() const { return landmarks.size(); }
+
+        /* Build a contraction hierarchy, after which weighted actorPath
+         * queries run on it instead of AStar or Dijkstras. Building may
+         * take minutes on a large graph. The hierarchy is saved in and
+         * loaded from snapshots with the graph.
+         * Return true if the hierarchy was built, and false otherwise.
+         */
+        bool buildHierarchy();
+
+        /* Return true if the graph has a contraction hierarchy. */
+        bool hasHierarchy() const { return hierarchy.isBuilt(); }
+
+        /* Build a hub label index with num_threads threads, after which
+         * unweighted actorPath queries are answered from the labels
+         * instead of BidirectionalBFS. The index is saved in and loaded
+         * from snapshots with the graph.
+         * Return true if the index was built, and false otherwise.
+         */
+        bool buildHubLabels(unsigned num_threads = 1);
+
+        /* Return the number of hub label entries, 0 without an index. */
+        size_t numHubLabels() const { return hubLabels.size(); }
+
+        /* Return the number of movies on a shortest path between existing
+         * actors src and dst, or INT_MAX if they aren't connected.
+         * Requires hub labels.
+         */
+        int hopDistance(uint32_t src, uint32_t dst) const { return hubLabels.distance(src, dst); }
+
+        /* Select the priority queue used by Dijkstras. BUCKET_QUEUE is the
+         * default, and falls back to HEAP_QUEUE on graphs with negative
+         * weights. Paths may differ between queues only among paths of
+         * equal cost.
+         */
+        void setDijkstraQueue(DijkstraQueue queue) { dijkstraQueue = queue; }
 
         /* Run Dijkstra's algorithm on the graph, starting at src node.
-         * Populate nodes with path data as it runs.
+         * Populate ws with path data as it runs.
          * Return false if src or dst node doesn't exist.
          */
-        bool Dijkstras(string src, string dst);
+        bool Dijkstras(SearchWorkspace& ws, uint32_t src, uint32_t dst) const;
 
-        /* Run Dijkstras/BFS from src to dst and return the path string.
-         * use_weighted_path = true -> Dijkstras
-         * use_weighted_path = false -> BFS 
+        /* Run Breadth First Search from src until every actor in targets
+         * has been reached, so one search answers many destinations.
+         * targets must be sorted and hold no duplicates. With no targets,
+         * every actor reachable from src is reached.
+         * Only movies released in or before max_year are followed.
+         * Populate ws with path data as it runs.
+         * Return the number of targets reached.
          */
-        string actorPath(string src, string dst, bool use_weighted_path);
+        size_t BFS(SearchWorkspace& ws, uint32_t src, const vector<uint32_t>& targets,
+            int max_year = numeric_limits<int>::max()) const;
 
-        /* Prepare the graph for actorconnections algorithm by
-         * creating nodes with no edges for all actors and 
-         * return pointer to a map containing movie->actors data.
+        /* Run Dijkstra's algorithm from src until every actor in targets
+         * has been settled, so one search answers many destinations.
+         * targets must be sorted and hold no duplicates. With no targets,
+         * every actor reachable from src is settled.
+         * Populate ws with path data as it runs.
+         * Return the number of targets settled.
          */
-        map<string, MovieActorList*>* prepActorConnections(const char* in_filename);
+        size_t Dijkstras(SearchWorkspace& ws, uint32_t src, const vector<uint32_t>& targets) const;
 
-        /* Run actorconnections algorithm on list of src and dst pairs.
-         * Use movie data map returned from prepActorConnections.
-         * Return vector of actorconnections data for each input pair.
+        /* Run A* search from src to dst, guided by lower bounds from the
+         * landmark index. Finds a path of the same cost as Dijkstras while
+         * settling far fewer actors. Without landmarks it runs as Dijkstras.
+         * Populate ws with path data as it runs.
+         * Return false if src or dst node doesn't exist.
+         */
+        bool AStar(SearchWorkspace& ws, uint32_t src, uint32_t dst) const;
+
+        /* Return the path string ending at dst from path data in ws. */
+        string formatPath(const SearchWorkspace& ws, uint32_t dst) const;
+
+        /* Return the path string through actors path[0 .. n), where
+         * pathMovies[i] is the movie shared by path[i] and path[i + 1].
          */
-        vector<string> actorConnections(map<string, MovieActorList*>* movie_map,
-            vector<string> src, vector<string> dst);
+        string formatPath(const vector<uint32_t>& path, const vector<uint32_t>& pathMovies) const;
 
-        /* Destructor */
-        ~ActorGraph();
+        /* Run Dijkstras/BFS from src to dst and return the path string.
+         * Actors in different components have no path, and are answered
+         * without searching.
+         * use_weighted_path = true -> contraction hierarchy if built,
+         *     AStar with landmarks, Dijkstras otherwise
+         * use_weighted_path = false -> hub labels if built,
+         *     BidirectionalBFS otherwise
+         * ws holds the search state, so queries with different workspaces
+         * can run concurrently.
+         */
+        string actorPath(SearchWorkspace& ws, const string& src, const string& dst,
+            bool use_weighted_path) const;
+
+        /* Run actorPath with a workspace allocated for this query only. */
+        string actorPath(const string& src, const string& dst, bool use_weighted_path) const;
+
+        /* Run actorconnections algorithm on list of src and dst pairs
+         * over the frozen graph.
+         * Return vector of actorconnections data for each input pair.
+         */
+        vector<string> actorConnections(const vector<string>& src, const vector<string>& dst) const;
 };
 
 #endif // ACTORGRAPH_H
@@ -0,0 +1,138 @@
+/* ActorOrdering.cpp
+ * Relabelings of the actors of a frozen Actor Graph that give co-stars
+ * nearby IDs, so a search walking a cast touches nearby entries of the
+ * per-actor arrays instead of entries scattered across them.
+ */
+
+#include <algorithm>
+#include <numeric>
+#include "ActorOrdering.h"
+
+using namespace std;
+
+/* Return the number of co-star links of every actor, counting a
+ * co-star once per movie they share.
+ */
+static vector<uint64_t> coStarLinks(const CSRView& csr) {
+    vector<uint64_t> links(csr.numActors(), 0);
+    for(uint32_t a = 0; a < csr.numActors(); a++) {
+        for(uint32_t i = csr.actorOffsets[a]; i < csr.actorOffsets[a + 1]; i++) {
+            uint32_t movie = csr.actorMovies[i];
+            links[a] += csr.movieOffsets[movie + 1] - csr.movieOffsets[movie] - 1;
+        }
+    }
+    return links;
+}
+
+/* Append src and every actor reachable from it that isn't placed yet to
+ * order, in breadth first order. With by_links, the actors first reached
+ * from each actor are appended in increasing order of co-star links, as
+ * Cuthill-McKee does.
+ */
+static void appendComponent(const CSRView& csr, uint32_t src, const vector<uint64_t>& links,
+    bool by_links, vector<bool>& placed, vector<bool>& movieDone, vector<uint32_t>& order) {
+    size_t head = order.size();
+    placed[src] = true;
+    order.push_back(src);
+
+    // order doubles as the BFS queue
+    while(head < order.size()) {
+        uint32_t curr = order[head++];
+        size_t first = order.size();
+
+        for(uint32_t i = csr.actorOffsets[curr]; i < csr.actorOffsets[curr + 1]; i++) {
+            uint32_t movie = csr.actorMovies[i];
+            if(movieDone[movie])
+                continue;
+            movieDone[movie] = true;
+
+            for(uint32_t j = csr.movieOffsets[movie]; j < csr.movieOffsets[movie + 1]; j++) {
+                uint32_t actor = csr.movieActors[j];
+                if(!placed[actor]) {
+                    placed[actor] = true;
+                    order.push_back(actor);
+                }
+            }
+        }
+
+        if(by_links) {
+            stable_sort(order.begin() + first, order.end(),
+                [&](uint32_t a, uint32_t b) { return links[a] < links[b]; });
+        }
+    }
+}
+
+/* Set strategy to the one named "bfs", "rcm" or "degree".
+ * Return true if the name is known, and false otherwise.
+ */
+bool ActorOrdering::parse(const string& name, Strategy& strategy) {
+    if(name == "bfs")
+        strategy = BFS_ORDER;
+    else if(name == "rcm")
+        strategy = RCM_ORDER;
+    else if(name == "degree")
+        strategy = DEGREE_ORDER;
+    else
+        return false;
+    return true;
+}
+
+/* Return the new ID of every actor of csr in the order of strategy.
+ * Ties keep the actors in their current ID order.
+ */
+vector<uint32_t> ActorOrdering::compute(const CSRView& csr, Strategy strategy) {
+    uint32_t num_actors = csr.numActors();
+    vector<uint64_t> links = coStarLinks(csr);
+
+    // Actors by current ID, which is also the order components are
+    // started from in BFS order
+    vector<uint32_t> order(num_actors);
+    iota(order.begin(), order.end(), 0);
+
+    if(strategy == DEGREE_ORDER) {
+        stable_sort(order.begin(), order.end(),
+            [&](uint32_t a, uint32_t b) { return links[a] > links[b]; });
+    } else {
+        // Cuthill-McKee starts each component from an actor with few links,
+        // which tends to lie on its edge and gives narrow BFS levels
+        vector<uint32_t> starts;
+        starts.swap(order);
+        if(strategy == RCM_ORDER) {
+            stable_sort(starts.begin(), starts.end(),
+                [&](uint32_t a, uint32_t b) { return links[a] < links[b]; });
+        }
+
+        vector<bool> placed(num_actors, false);
+        vector<bool> movieDone(csr.numMovies(), false);
+        order.reserve(num_actors);
+        for(uint32_t src : starts) {
+            if(!placed[src])
+                appendComponent(csr, src, links, strategy == RCM_ORDER, placed, movieDone, order);
+        }
+
+        if(strategy == RCM_ORDER)
+            reverse(order.begin(), order.end());
+    }
+
+    vector<uint32_t> new_id(num_actors);
+    for(uint32_t i = 0; i < num_actors; i++)
+        new_id[order[i]] = i;
+    return new_id;
+}
+
+/* Return the mean difference between the IDs of consecutive actors
+ * in each movie's cast, or 0 if no cast has two actors.
+ */
+double ActorOrdering::averageCastGap(const CSRView& csr) {
+    uint64_t total = 0;
+    uint64_t gaps = 0;
+    for(uint32_t m = 0; m < csr.numMovies(); m++) {
+        for(uint32_t j = csr.movieOffsets[m] + 1; j < csr.movieOffsets[m + 1]; j++) {
+            uint32_t a = csr.movieActors[j - 1];
+            uint32_t b = csr.movieActors[j];
+            total += (a > b) ? a - b : b - a;
+            gaps++;
+        }
+    }
+    return gaps > 0 ? (double)total / gaps : 0;
+}
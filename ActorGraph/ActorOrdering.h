@@ -0,0 +1,42 @@
+/* ActorOrdering.h
+ * Relabelings of the actors of a frozen Actor Graph that give co-stars
+ * nearby IDs, so a search walking a cast touches nearby entries of the
+ * per-actor arrays instead of entries scattered across them.
+ */
+
+#ifndef ACTORORDERING_H
+#define ACTORORDERING_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "CSRView.h"
+
+using namespace std;
+
+class ActorOrdering {
+    public:
+        /* Orders actors can be relabeled in */
+        enum Strategy {
+            BFS_ORDER,     // Breadth first order, one component after another
+            RCM_ORDER,     // Reverse Cuthill-McKee order
+            DEGREE_ORDER   // Most co-star links first
+        };
+
+        /* Set strategy to the one named "bfs", "rcm" or "degree".
+         * Return true if the name is known, and false otherwise.
+         */
+        static bool parse(const string& name, Strategy& strategy);
+
+        /* Return the new ID of every actor of csr in the order of strategy.
+         * Ties keep the actors in their current ID order.
+         */
+        static vector<uint32_t> compute(const CSRView& csr, Strategy strategy);
+
+        /* Return the mean difference between the IDs of consecutive actors
+         * in each movie's cast, or 0 if no cast has two actors.
+         */
+        static double averageCastGap(const CSRView& csr);
+};
+
+#endif // ACTORORDERING_H
@@ -0,0 +1,36 @@
+/* ArrayView.h
+ * Read-only view of a contiguous array owned elsewhere, either by a
+ * vector or by a memory-mapped file.
+ */
+
+#ifndef ARRAYVIEW_H
+#define ARRAYVIEW_H
+
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+template <typename T>
+class ArrayView {
+    private:
+        const T* ptr;
+        size_t length;
+
+    public:
+        /* Constructors */
+        ArrayView() : ptr(nullptr), length(0) {}
+        ArrayView(const T* ptr, size_t length) : ptr(ptr), length(length) {}
+        ArrayView(const vector<T>& v) : ptr(v.data()), length(v.size()) {}
+
+        const T& operator[](size_t i) const { return ptr[i]; }
+
+        const T* data() const { return ptr; }
+        size_t size() const { return length; }
+        bool empty() const { return length == 0; }
+
+        const T* begin() const { return ptr; }
+        const T* end() const { return ptr + length; }
+};
+
+#endif // ARRAYVIEW_H
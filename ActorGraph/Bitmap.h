@@ -0,0 +1,86 @@
+/* Bitmap.h
+ * Dense fixed-size bitmap stored in 64-bit words, with word-level
+ * operations for frontier and visited sets.
+ */
+
+#ifndef BITMAP_H
+#define BITMAP_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+using namespace std;
+
+class Bitmap {
+    private:
+        vector<uint64_t> bits;
+        size_t length;
+
+    public:
+        /* Constructor */
+        Bitmap(size_t length = 0) : bits((length + 63) / 64, 0), length(length) {}
+
+        /* Resize to length bits, all cleared. */
+        void assign(size_t n) {
+            bits.assign((n + 63) / 64, 0);
+            length = n;
+        }
+
+        size_t size() const { return length; }
+
+        bool test(size_t i) const { return (bits[i >> 6] >> (i & 63)) & 1; }
+        void set(size_t i) { bits[i >> 6] |= uint64_t(1) << (i & 63); }
+        void reset(size_t i) { bits[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+
+        /* Clear every bit. */
+        void clear() { fill(bits.begin(), bits.end(), 0); }
+
+        /* Return the number of set bits. */
+        size_t count() const {
+            size_t n = 0;
+            for(uint64_t word : bits)
+                n += __builtin_popcountll(word);
+            return n;
+        }
+
+        /* Return true if no bit is set. */
+        bool none() const {
+            for(uint64_t word : bits) {
+                if(word)
+                    return false;
+            }
+            return true;
+        }
+
+        /* Swap contents with other, which must have the same size. */
+        void swap(Bitmap& other) {
+            bits.swap(other.bits);
+            std::swap(length, other.length);
+        }
+
+        /* Call fn(i) for every set bit i, in increasing order. */
+        template <typename Function>
+        void forEach(Function fn) const {
+            for(size_t w = 0; w < bits.size(); w++) {
+                for(uint64_t word = bits[w]; word; word &= word - 1)
+                    fn(w * 64 + __builtin_ctzll(word));
+            }
+        }
+
+        /* Call fn(i) for every cleared bit i below size(), in increasing order. */
+        template <typename Function>
+        void forEachClear(Function fn) const {
+            for(size_t w = 0; w < bits.size(); w++) {
+                uint64_t word = ~bits[w];
+                if(w == bits.size() - 1 && (length & 63))
+                    word &= (uint64_t(1) << (length & 63)) - 1;
+
+                for(; word; word &= word - 1)
+                    fn(w * 64 + __builtin_ctzll(word));
+            }
+        }
+};
+
+#endif // BITMAP_H
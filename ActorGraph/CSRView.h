@@ -0,0 +1,44 @@
+/* CSRView.h
+ * Read-only view of the compressed sparse row (CSR) arrays of a frozen
+ * Actor Graph, for search engines that run directly on the arrays.
+ */
+
+#ifndef CSRVIEW_H
+#define CSRVIEW_H
+
+#include <cstdint>
+#include "ArrayView.h"
+
+using namespace std;
+
+struct CSRView {
+    /* Actor i starred in movies actorMovies[actorOffsets[i] .. actorOffsets[i + 1]).
+     * Movie m's cast is movieActors[movieOffsets[m] .. movieOffsets[m + 1]).
+     */
+    ArrayView<uint32_t> actorOffsets;
+    ArrayView<uint32_t> actorMovies;
+    ArrayView<uint32_t> movieOffsets;
+    ArrayView<uint32_t> movieActors;
+    ArrayView<int> movieYear;
+    ArrayView<int> movieWeight;
+
+    /* Return the number of actors in the graph. */
+    uint32_t numActors() const { return actorOffsets.empty() ? 0 : actorOffsets.size() - 1; }
+
+    /* Return the number of movies in the graph. */
+    uint32_t numMovies() const { return movieOffsets.empty() ? 0 : movieOffsets.size() - 1; }
+
+    /* Return the movies actor starred in. */
+    ArrayView<uint32_t> moviesOf(uint32_t actor) const {
+        return ArrayView<uint32_t>(actorMovies.data() + actorOffsets[actor],
+            actorOffsets[actor + 1] - actorOffsets[actor]);
+    }
+
+    /* Return the cast of movie. */
+    ArrayView<uint32_t> castOf(uint32_t movie) const {
+        return ArrayView<uint32_t>(movieActors.data() + movieOffsets[movie],
+            movieOffsets[movie + 1] - movieOffsets[movie]);
+    }
+};
+
+#endif // CSRVIEW_H
@@ -0,0 +1,143 @@
+/* CastFileReader.cpp
+ * Memory-mapped reader for tab-delimited movie cast files.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include "CastFileReader.h"
+#include "Parallel.h"
+
+using namespace std;
+
+/* Return the first byte of the file after the header line. */
+const char* CastFileReader::recordsBegin() const {
+    if(file.size() == 0)
+        return recordsEnd();
+
+    const char* eol = (const char*)memchr(file.data(), '\n', file.size());
+    if(!eol)
+        return recordsEnd();
+    return eol + 1;
+}
+
+/* Split the records into num_chunks line-aligned chunks.
+ * Return the num_chunks + 1 chunk boundaries.
+ */
+vector<const char*> CastFileReader::splitRecords(unsigned num_chunks) const {
+    const char* begin = recordsBegin();
+    const char* end = recordsEnd();
+
+    vector<const char*> bounds(num_chunks + 1, end);
+    bounds[0] = begin;
+
+    for(unsigned c = 1; c < num_chunks; c++) {
+        const char* p = begin + (end - begin) * c / num_chunks;
+        if(p < bounds[c - 1])
+            p = bounds[c - 1];
+
+        // Move the boundary to the start of the next line
+        if(p > begin && p < end && p[-1] != '\n') {
+            const char* eol = (const char*)memchr(p, '\n', end - p);
+            p = eol ? eol + 1 : end;
+        }
+        bounds[c] = p;
+    }
+
+    return bounds;
+}
+
+/* Records of one chunk of a cast file, with actors and movies interned
+ * into tables local to the chunk.
+ */
+struct CastChunk {
+    StringTable actors;
+    MovieTable movies;
+    vector<MovieActorList> movie_list; // Indexed by local movie ID
+};
+
+/* Read in_filename into a list of movies and their actors,
+ * interning every actor and movie. movies must start out empty.
+ * With num_threads > 1, chunks of the file are parsed and interned
+ * on separate threads, then merged in file order, so IDs and cast
+ * order are identical to a single-threaded read.
+ * Return pointer to the list ordered by year, then by title,
+ * or nullptr if the file couldn't be read.
+ */
+vector<MovieActorList>* CastFileReader::readMovies(const char* in_filename,
+    StringTable& actors, MovieTable& movies, unsigned num_threads) {
+    CastFileReader reader;
+    if(!reader.open(in_filename)) {
+        cerr << "Failed to read " << in_filename << "!\n";
+        return nullptr;
+    }
+
+    // List of movies and actors in that movie, indexed by movie ID
+    vector<MovieActorList>* movie_list = new vector<MovieActorList>;
+
+    if(num_threads <= 1) {
+        reader.forEachRecord([&](string_view actor_name, string_view movie_title, int movie_year) {
+            // Intern actor and movie (Note: Interning prevents duplicates)
+            uint32_t actor = actors.intern(actor_name);
+            uint32_t movie = movies.intern(movie_title, movie_year);
+
+            // New movie gets the next slot in the list
+            if(movie == movie_list->size())
+                movie_list->push_back(MovieActorList(movie, movie_year));
+
+            // Add actor to movie's list
+            (*movie_list)[movie].actorList.push_back(actor);
+        });
+    } else {
+        // Parse and intern each chunk into its own tables
+        vector<const char*> bounds = reader.splitRecords(num_threads);
+        vector<CastChunk> chunks(num_threads);
+
+        runThreads(num_threads, [&](unsigned t) {
+            CastChunk& chunk = chunks[t];
+            forEachRecord(bounds[t], bounds[t + 1],
+                [&](string_view actor_name, string_view movie_title, int movie_year) {
+                    uint32_t actor = chunk.actors.intern(actor_name);
+                    uint32_t movie = chunk.movies.intern(movie_title, movie_year);
+
+                    if(movie == chunk.movie_list.size())
+                        chunk.movie_list.push_back(MovieActorList(movie, movie_year));
+
+                    chunk.movie_list[movie].actorList.push_back(actor);
+                });
+        });
+
+        // Merge chunks in file order. Local IDs follow first appearance in
+        // the chunk, so interning them in order reproduces the global
+        // first-appearance order of a single-threaded read.
+        vector<uint32_t> actorIds;
+        for(CastChunk& chunk : chunks) {
+            actorIds.resize(chunk.actors.size());
+            for(uint32_t a = 0; a < chunk.actors.size(); a++)
+                actorIds[a] = actors.intern(chunk.actors.lookup(a));
+
+            for(auto& item : chunk.movie_list) {
+                uint32_t movie = movies.intern(chunk.movies.title(item.movie), item.year);
+                if(movie == movie_list->size())
+                    movie_list->push_back(MovieActorList(movie, item.year));
+
+                auto& actorList = (*movie_list)[movie].actorList;
+                for(uint32_t a : item.actorList)
+                    actorList.push_back(actorIds[a]);
+            }
+
+            // Release the chunk's tables once merged
+            chunk.movie_list.clear();
+            chunk.movie_list.shrink_to_fit();
+        }
+    }
+
+    // Order movies by year, then by title
+    sort(movie_list->begin(), movie_list->end(),
+        [&movies](const MovieActorList& a, const MovieActorList& b) {
+            if(a.year != b.year)
+                return a.year < b.year;
+            return movies.title(a.movie) < movies.title(b.movie);
+        });
+
+    return movie_list;
+}
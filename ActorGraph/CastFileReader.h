@@ -0,0 +1,111 @@
+/* CastFileReader.h
+ * Memory-mapped reader for tab-delimited movie cast files.
+ * Fields are handed out as views into the mapped file, so reading a
+ * record doesn't allocate.
+ */
+
+#ifndef CASTFILEREADER_H
+#define CASTFILEREADER_H
+
+#include <cstring>
+#include <charconv>
+#include <string_view>
+#include <vector>
+#include "MappedFile.h"
+#include "MovieActorList.h"
+#include "StringTable.h"
+
+using namespace std;
+
+class CastFileReader {
+    private:
+        MappedFile file;
+
+    public:
+        /* Constructor */
+        CastFileReader() {}
+
+        /* Map in_filename read-only into memory.
+         * Return true if file was mapped successfully, and false otherwise.
+         */
+        bool open(const char* in_filename) { return file.open(in_filename, true); }
+
+        /* Unmap the file. Views handed out by the reader become invalid. */
+        void close() { file.close(); }
+
+        /* Return the first byte of the file after the header line. */
+        const char* recordsBegin() const;
+
+        /* Return one past the last byte of the file. */
+        const char* recordsEnd() const { return file.data() + file.size(); }
+
+        /* Call visit(actor_name, movie_title, movie_year) for each record
+         * in [begin, end). begin must be the start of a line.
+         * Lines that don't have exactly 3 columns or a numeric year are skipped.
+         */
+        template <typename Visitor>
+        static void forEachRecord(const char* begin, const char* end, Visitor visit);
+
+        /* Call visit(actor_name, movie_title, movie_year) for each record
+         * of the file, skipping the header line.
+         */
+        template <typename Visitor>
+        void forEachRecord(Visitor visit) const {
+            forEachRecord(recordsBegin(), recordsEnd(), visit);
+        }
+
+        /* Split the records into num_chunks line-aligned chunks.
+         * Return the num_chunks + 1 chunk boundaries.
+         */
+        vector<const char*> splitRecords(unsigned num_chunks) const;
+
+        /* Read in_filename into a list of movies and their actors,
+         * interning every actor and movie. movies must start out empty.
+         * With num_threads > 1, chunks of the file are parsed and interned
+         * on separate threads, then merged in file order, so IDs and cast
+         * order are identical to a single-threaded read.
+         * Return pointer to the list ordered by year, then by title,
+         * or nullptr if the file couldn't be read.
+         */
+        static vector<MovieActorList>* readMovies(const char* in_filename,
+            StringTable& actors, MovieTable& movies, unsigned num_threads = 1);
+};
+
+/* Call visit(actor_name, movie_title, movie_year) for each record
+ * in [begin, end). begin must be the start of a line.
+ * Lines that don't have exactly 3 columns or a numeric year are skipped.
+ */
+template <typename Visitor>
+void CastFileReader::forEachRecord(const char* begin, const char* end, Visitor visit) {
+    const char* line = begin;
+
+    while(line < end) {
+        // memchr scans a word or vector at a time, much faster than getline
+        const char* eol = (const char*)memchr(line, '\n', end - line);
+        if(!eol)
+            eol = end;
+
+        // Split the line at its two tab characters
+        const char* tab1 = (const char*)memchr(line, '\t', eol - line);
+        const char* tab2 = tab1 ? (const char*)memchr(tab1 + 1, '\t', eol - tab1 - 1) : nullptr;
+        const char* tab3 = tab2 ? (const char*)memchr(tab2 + 1, '\t', eol - tab2 - 1) : nullptr;
+
+        // We should have exactly 3 columns
+        if(tab2 && !tab3) {
+            const char* year = tab2 + 1;
+            while(year < eol && *year == ' ')
+                year++;
+
+            int movie_year;
+            if(from_chars(year, eol, movie_year).ec == errc()) {
+                visit(string_view(line, tab1 - line),
+                      string_view(tab1 + 1, tab2 - tab1 - 1),
+                      movie_year);
+            }
+        }
+
+        line = eol + 1;
+    }
+}
+
+#endif // CASTFILEREADER_H
@@ -0,0 +1,247 @@
+/* CentralityEngine.cpp
+ * Closeness, harmonic and betweenness centrality of every actor of a
+ * frozen Actor Graph, from all actors or a random sample of them.
+ */
+
+#include <fstream>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include "CentralityEngine.h"
+#include "Parallel.h"
+#include "util.h"
+
+using namespace std;
+
+const uint32_t CentralityEngine::UNSET;
+
+/* Allocate the search state and sums of one thread */
+CentralityEngine::Workspace::Workspace(uint32_t num_actors, uint32_t num_movies) :
+    distance(num_actors, UNSET), movieDistance(num_movies, UNSET),
+    sigma(num_actors), movieSigma(num_movies), delta(num_actors), movieDelta(num_movies),
+    distanceSum(num_actors, 0), reached(num_actors, 0), harmonic(num_actors, 0),
+    betweenness(num_actors, 0), links(0) {}
+
+/* Prepare to score the actors of a frozen graph whose links aren't
+ * compressed. The graph must outlive the engine.
+ */
+CentralityEngine::CentralityEngine(const ActorGraph& graph) :
+    graph(graph), csr(graph.csrView()), numSources(0), numLinks(0), elapsed(0) {}
+
+/* Search from src, adding its distances and dependencies to the
+ * sums of ws.
+ */
+void CentralityEngine::searchFrom(Workspace& ws, uint32_t src) const {
+    ws.order.clear();
+    ws.movieOrder.clear();
+    ws.levelStart.clear();
+    ws.movieLevelStart.clear();
+
+    ws.distance[src] = 0;
+    ws.sigma[src] = 1;
+    ws.delta[src] = 0;
+    ws.order.push_back(src);
+
+    // Level by level, so every path into a level is counted before the
+    // level passes its counts on
+    uint32_t d = 0;
+    size_t begin = 0;
+    while(begin < ws.order.size()) {
+        size_t end = ws.order.size();
+        ws.levelStart.push_back(begin);
+        ws.movieLevelStart.push_back(ws.movieOrder.size());
+
+        // Movies first reached from this level sum the paths of their
+        // cast in it
+        for(size_t i = begin; i < end; i++) {
+            uint32_t curr = ws.order[i];
+            for(uint32_t movie : csr.moviesOf(curr)) {
+                ws.links++;
+                if(ws.movieDistance[movie] == UNSET) {
+                    ws.movieDistance[movie] = d;
+                    ws.movieSigma[movie] = 0;
+                    ws.movieOrder.push_back(movie);
+                }
+                if(ws.movieDistance[movie] == d)
+                    ws.movieSigma[movie] += ws.sigma[curr];
+            }
+        }
+
+        // Their cast not reached yet is the next level
+        for(size_t i = ws.movieLevelStart.back(); i < ws.movieOrder.size(); i++) {
+            uint32_t movie = ws.movieOrder[i];
+            for(uint32_t next : csr.castOf(movie)) {
+                ws.links++;
+                if(ws.distance[next] == UNSET) {
+                    ws.distance[next] = d + 1;
+                    ws.sigma[next] = 0;
+                    ws.order.push_back(next);
+                }
+                if(ws.distance[next] == d + 1)
+                    ws.sigma[next] += ws.movieSigma[movie];
+            }
+        }
+
+        begin = end;
+        d++;
+    }
+
+    // Accumulate dependencies from the deepest level back to the source.
+    // Movies pass on the dependencies of the cast they lead to, counting
+    // each of those actors as a path end, and actors those of the movies
+    // they lead to.
+    size_t num_levels = ws.levelStart.size();
+    for(size_t k = num_levels; k-- > 0;) {
+        size_t movie_end = (k + 1 < num_levels) ? ws.movieLevelStart[k + 1] : ws.movieOrder.size();
+        for(size_t i = ws.movieLevelStart[k]; i < movie_end; i++) {
+            uint32_t movie = ws.movieOrder[i];
+            double sum = 0;
+            for(uint32_t next : csr.castOf(movie)) {
+                ws.links++;
+                if(ws.distance[next] == k + 1)
+                    sum += (1 + ws.delta[next]) / ws.sigma[next];
+            }
+            ws.movieDelta[movie] = ws.movieSigma[movie] * sum;
+        }
+
+        size_t actor_end = (k + 1 < num_levels) ? ws.levelStart[k + 1] : ws.order.size();
+        for(size_t i = ws.levelStart[k]; i < actor_end; i++) {
+            uint32_t curr = ws.order[i];
+            double sum = 0;
+            for(uint32_t movie : csr.moviesOf(curr)) {
+                ws.links++;
+                if(ws.movieDistance[movie] == k)
+                    sum += ws.movieDelta[movie] / ws.movieSigma[movie];
+            }
+            ws.delta[curr] = ws.sigma[curr] * sum;
+        }
+    }
+
+    for(size_t i = 1; i < ws.order.size(); i++) {
+        uint32_t actor = ws.order[i];
+        ws.distanceSum[actor] += ws.distance[actor];
+        ws.reached[actor]++;
+        ws.harmonic[actor] += 1.0 / ws.distance[actor];
+        ws.betweenness[actor] += ws.delta[actor];
+    }
+
+    // Reset only what this search reached
+    for(uint32_t actor : ws.order)
+        ws.distance[actor] = UNSET;
+    for(uint32_t movie : ws.movieOrder)
+        ws.movieDistance[movie] = UNSET;
+}
+
+/* Score every actor from num_samples sources picked at random with
+ * seed, or from every actor if num_samples is 0 or at least the
+ * number of actors. Sampled scores are scaled to estimate the exact
+ * ones. Sources are handed out to num_threads threads one at a
+ * time, each thread with its own workspace. With progress, the
+ * number of sources done and the rate are written to it every 5%.
+ */
+void CentralityEngine::run(uint32_t num_samples, unsigned seed, unsigned num_threads,
+    ostream* progress) {
+    Timer timer;
+    timer.begin_timer();
+
+    uint32_t num_actors = graph.numActors();
+    scores.assign(num_actors, ActorCentrality{0, 0, 0});
+    numSources = 0;
+    numLinks = 0;
+    elapsed = 0;
+    if(!graph.isFrozen() || graph.isCompressed() || num_actors == 0)
+        return;
+    if(num_threads < 1)
+        num_threads = 1;
+
+    // Sources in ID order, so neighbouring searches share cache lines
+    vector<uint32_t> sources(num_actors);
+    iota(sources.begin(), sources.end(), 0);
+    if(num_samples > 0 && num_samples < num_actors) {
+        mt19937 rng(seed);
+        shuffle(sources.begin(), sources.end(), rng);
+        sources.resize(num_samples);
+        sort(sources.begin(), sources.end());
+    }
+    numSources = sources.size();
+
+    // Searches from far-reaching sources take longer, so threads take the
+    // next source as they finish one
+    vector<unique_ptr<Workspace>> workspaces(num_threads);
+    atomic<uint32_t> done(0);
+    mutex progress_mutex;
+    uint32_t step = max(numSources / 20, 1u);
+    parallelForEach(num_threads, numSources, [&](unsigned t, size_t i) {
+        if(!workspaces[t])
+            workspaces[t].reset(new Workspace(num_actors, graph.numMovies()));
+        searchFrom(*workspaces[t], sources[i]);
+
+        uint32_t finished = ++done;
+        if(progress && (finished % step == 0 || finished == numSources)) {
+            lock_guard<mutex> lock(progress_mutex);
+            double seconds = timer.end_timer()/(1000000000.00);
+            *progress << "Searched " << finished << " of " << numSources << " sources, "
+                << finished / seconds << " sources/s" << endl;
+        }
+    });
+
+    // Merge the sums of every thread
+    vector<uint64_t> distance_sum(num_actors, 0);
+    vector<uint32_t> reached(num_actors, 0);
+    for(auto& ws : workspaces) {
+        if(!ws)
+            continue;
+
+        for(uint32_t a = 0; a < num_actors; a++) {
+            distance_sum[a] += ws->distanceSum[a];
+            reached[a] += ws->reached[a];
+            scores[a].harmonic += ws->harmonic[a];
+            scores[a].betweenness += ws->betweenness[a];
+        }
+        numLinks += ws->links;
+    }
+
+    vector<bool> is_source(num_actors, false);
+    for(uint32_t src : sources)
+        is_source[src] = true;
+
+    for(uint32_t a = 0; a < num_actors; a++) {
+        // An actor's own search says nothing of its distance to others
+        uint32_t others = numSources - (is_source[a] ? 1 : 0);
+        if(others == 0 || reached[a] == 0) {
+            scores[a].harmonic = 0;
+            scores[a].betweenness = 0;
+            continue;
+        }
+
+        // Scale the sums over the sampled sources up to all actors. Each
+        // pair of actors is counted from both ends, so betweenness is halved.
+        scores[a].closeness = ((double)reached[a] / others) * ((double)reached[a] / distance_sum[a]);
+        scores[a].harmonic *= (double)(num_actors - 1) / others;
+        scores[a].betweenness *= (double)num_actors / numSources / 2;
+    }
+
+    elapsed = timer.end_timer();
+}
+
+/* Write one line per actor with its name and scores, tab-separated,
+ * after a header line.
+ * Return true if the file was written, and false otherwise.
+ */
+bool CentralityEngine::writeTSV(const char* out_filename) const {
+    ofstream outfile(out_filename);
+    if(!outfile)
+        return false;
+
+    outfile << "actor\tcloseness\tharmonic\tbetweenness" << '\n';
+    for(uint32_t a = 0; a < scores.size(); a++) {
+        outfile << graph.actorName(a) << '\t' << scores[a].closeness << '\t'
+            << scores[a].harmonic << '\t' << scores[a].betweenness << '\n';
+    }
+
+    outfile.close();
+    return !outfile.fail();
+}
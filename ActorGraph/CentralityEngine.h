@@ -0,0 +1,111 @@
+/* CentralityEngine.h
+ * Closeness, harmonic and betweenness centrality of every actor of a
+ * frozen Actor Graph, from all actors or a random sample of them.
+ *
+ * Distances are movie hops. A shortest path is a sequence of movies, so
+ * two actors sharing two movies are joined by two shortest paths, and
+ * betweenness is computed with Brandes' algorithm on the actor-movie
+ * graph, counting actors only as endpoints and intermediates.
+ */
+
+#ifndef CENTRALITYENGINE_H
+#define CENTRALITYENGINE_H
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include "ActorGraph.h"
+#include "CSRView.h"
+
+using namespace std;
+
+/* Centrality scores of one actor */
+struct ActorCentrality {
+    double closeness;    // Reach / (n - 1) times reach / distance sum (Wasserman-Faust)
+    double harmonic;     // Sum of 1 / distance to every other actor
+    double betweenness;  // Shortest paths between other actors through this one
+};
+
+class CentralityEngine {
+    private:
+        const ActorGraph& graph;
+        CSRView csr;
+
+        /* Search state and partial sums of one thread */
+        struct Workspace {
+            // Level of each actor and movie, UNSET when not reached
+            vector<uint32_t> distance;
+            vector<uint32_t> movieDistance;
+
+            // Shortest paths from the source, and dependency on the source
+            vector<double> sigma;
+            vector<double> movieSigma;
+            vector<double> delta;
+            vector<double> movieDelta;
+
+            // Actors and movies reached, level by level, with the index where
+            // each level starts
+            vector<uint32_t> order;
+            vector<uint32_t> movieOrder;
+            vector<size_t> levelStart;
+            vector<size_t> movieLevelStart;
+
+            // Sums over the sources searched by the thread
+            vector<uint64_t> distanceSum;
+            vector<uint32_t> reached;
+            vector<double> harmonic;
+            vector<double> betweenness;
+            uint64_t links;
+
+            Workspace(uint32_t num_actors, uint32_t num_movies);
+        };
+
+        vector<ActorCentrality> scores;
+        uint32_t numSources;
+        uint64_t numLinks;
+        long long elapsed;
+
+        /* Search from src, adding its distances and dependencies to the
+         * sums of ws.
+         */
+        void searchFrom(Workspace& ws, uint32_t src) const;
+
+    public:
+        /* Marks an actor or movie not reached by the current search */
+        static const uint32_t UNSET = 0xFFFFFFFF;
+
+        /* Prepare to score the actors of a frozen graph whose links aren't
+         * compressed. The graph must outlive the engine.
+         */
+        CentralityEngine(const ActorGraph& graph);
+
+        /* Score every actor from num_samples sources picked at random with
+         * seed, or from every actor if num_samples is 0 or at least the
+         * number of actors. Sampled scores are scaled to estimate the exact
+         * ones. Sources are handed out to num_threads threads one at a
+         * time, each thread with its own workspace. With progress, the
+         * number of sources done and the rate are written to it every 5%.
+         */
+        void run(uint32_t num_samples, unsigned seed, unsigned num_threads,
+            ostream* progress = nullptr);
+
+        /* Return the scores of the last run, indexed by actor ID. */
+        const vector<ActorCentrality>& results() const { return scores; }
+
+        /* Return the number of sources of the last run. */
+        uint32_t sources() const { return numSources; }
+
+        /* Return the number of actor-movie links scanned in the last run. */
+        uint64_t linksScanned() const { return numLinks; }
+
+        /* Return the duration of the last run in nanoseconds. */
+        long long nanoseconds() const { return elapsed; }
+
+        /* Write one line per actor with its name and scores, tab-separated,
+         * after a header line.
+         * Return true if the file was written, and false otherwise.
+         */
+        bool writeTSV(const char* out_filename) const;
+};
+
+#endif // CENTRALITYENGINE_H
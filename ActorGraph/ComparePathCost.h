@@ -5,13 +5,21 @@
 #ifndef COMPAREPATHCOST_H
 #define COMPAREPATHCOST_H
 
+#include "StringTable.h"
+
 class ComparePathCost {
+    private:
+        // Actor names, used to break ties between equal costs
+        const StringTable* names;
+
     public:
-        bool operator()(pair<int, ActorNode*> n1, pair<int, ActorNode*> n2) {
+        ComparePathCost(const StringTable* names) : names(names) {}
+
+        bool operator()(pair<int, uint32_t> n1, pair<int, uint32_t> n2) {
             if(n1.first != n2.first)
                 return n1.first > n2.first;
             else
-                return n1.second->name > n2.second->name;
+                return names->lookup(n1.second) > names->lookup(n2.second);
         }
 };
 
@@ -0,0 +1,62 @@
+/* CompressedAdjacency.cpp
+ * Read-only compressed copy of the actor-movie links of a frozen Actor
+ * Graph. Each list keeps its order and stores every ID as the zigzag
+ * varint of its difference from the previous one, so lists of nearby
+ * IDs take one or two bytes per link instead of four.
+ */
+
+#include <limits>
+#include "CompressedAdjacency.h"
+
+using namespace std;
+
+/* Encode the lists ids[offsets[i] .. offsets[i + 1]) into bytes, with
+ * list i starting at bytes[byte_offsets[i]].
+ * Return false if the encoding would take 4 GB or more.
+ */
+static bool encodeLists(ArrayView<uint32_t> offsets, ArrayView<uint32_t> ids,
+    vector<uint32_t>& byte_offsets, vector<uint8_t>& bytes) {
+    byte_offsets.assign(1, 0);
+    bytes.clear();
+    bytes.reserve(ids.size() * 2);
+
+    for(size_t i = 0; i + 1 < offsets.size(); i++) {
+        uint32_t prev = 0;
+        for(uint32_t j = offsets[i]; j < offsets[i + 1]; j++) {
+            // Differences wrap around, so any order of IDs encodes
+            uint32_t delta = ids[j] - prev;
+            uint32_t zigzag = (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+            prev = ids[j];
+
+            while(zigzag >= 0x80) {
+                bytes.push_back((uint8_t)(zigzag | 0x80));
+                zigzag >>= 7;
+            }
+            bytes.push_back((uint8_t)zigzag);
+        }
+
+        if(bytes.size() > numeric_limits<uint32_t>::max())
+            return false;
+        byte_offsets.push_back(bytes.size());
+    }
+
+    bytes.shrink_to_fit();
+    return true;
+}
+
+/* Encode the links of the graph csr.
+ * Return true if they were encoded, and false if either list
+ * would take 4 GB or more.
+ */
+bool CompressedAdjacency::build(const CSRView& csr) {
+    if(!encodeLists(csr.actorOffsets, csr.actorMovies, actorOffsets, actorBytes)
+        || !encodeLists(csr.movieOffsets, csr.movieActors, movieOffsets, movieBytes)) {
+        vector<uint32_t>().swap(actorOffsets);
+        vector<uint8_t>().swap(actorBytes);
+        vector<uint32_t>().swap(movieOffsets);
+        vector<uint8_t>().swap(movieBytes);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,114 @@
+/* CompressedAdjacency.h
+ * Read-only compressed copy of the actor-movie links of a frozen Actor
+ * Graph. Each list keeps its order and stores every ID as the zigzag
+ * varint of its difference from the previous one, so lists of nearby
+ * IDs take one or two bytes per link instead of four.
+ */
+
+#ifndef COMPRESSEDADJACENCY_H
+#define COMPRESSEDADJACENCY_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "CSRView.h"
+
+using namespace std;
+
+/* One compressed list, decoded as it is iterated */
+class VarintList {
+    private:
+        const uint8_t* first;
+        const uint8_t* last;
+
+    public:
+        class Iterator {
+            private:
+                const uint8_t* curr;   // Encoding of the current ID
+                const uint8_t* next;   // Encoding of the one after
+                const uint8_t* last;
+                uint32_t value;
+
+                /* Decode the ID at curr from its difference to value. */
+                void decode() {
+                    uint32_t zigzag = 0;
+                    int shift = 0;
+                    next = curr;
+                    while(*next & 0x80) {
+                        zigzag |= (uint32_t)(*next++ & 0x7F) << shift;
+                        shift += 7;
+                    }
+                    zigzag |= (uint32_t)*next++ << shift;
+                    value += (zigzag >> 1) ^ (0u - (zigzag & 1));
+                }
+
+            public:
+                Iterator(const uint8_t* curr, const uint8_t* last) :
+                    curr(curr), next(curr), last(last), value(0) {
+                    if(curr != last)
+                        decode();
+                }
+
+                uint32_t operator*() const { return value; }
+
+                Iterator& operator++() {
+                    curr = next;
+                    if(curr != last)
+                        decode();
+                    return *this;
+                }
+
+                bool operator!=(const Iterator& other) const { return curr != other.curr; }
+        };
+
+        /* Constructor */
+        VarintList(const uint8_t* first, const uint8_t* last) : first(first), last(last) {}
+
+        Iterator begin() const { return Iterator(first, last); }
+        Iterator end() const { return Iterator(last, last); }
+};
+
+class CompressedAdjacency {
+    private:
+        /* Actor i's movies are encoded in actorBytes[actorOffsets[i] ..
+         * actorOffsets[i + 1]), and movie m's cast in movieBytes[
+         * movieOffsets[m] .. movieOffsets[m + 1]).
+         */
+        vector<uint32_t> actorOffsets;
+        vector<uint8_t> actorBytes;
+        vector<uint32_t> movieOffsets;
+        vector<uint8_t> movieBytes;
+
+    public:
+        /* Constructor */
+        CompressedAdjacency() {}
+
+        /* Encode the links of the graph csr.
+         * Return true if they were encoded, and false if either list
+         * would take 4 GB or more.
+         */
+        bool build(const CSRView& csr);
+
+        /* Return true if the links have been encoded. */
+        bool isBuilt() const { return !actorOffsets.empty(); }
+
+        /* Return the movies actor starred in, in CSR order. */
+        VarintList moviesOf(uint32_t actor) const {
+            return VarintList(actorBytes.data() + actorOffsets[actor],
+                actorBytes.data() + actorOffsets[actor + 1]);
+        }
+
+        /* Return the cast of movie, in CSR order. */
+        VarintList castOf(uint32_t movie) const {
+            return VarintList(movieBytes.data() + movieOffsets[movie],
+                movieBytes.data() + movieOffsets[movie + 1]);
+        }
+
+        /* Return the number of bytes the encoded links take. */
+        size_t sizeInBytes() const {
+            return (actorOffsets.size() + movieOffsets.size()) * sizeof(uint32_t)
+                + actorBytes.size() + movieBytes.size();
+        }
+};
+
+#endif // COMPRESSEDADJACENCY_H
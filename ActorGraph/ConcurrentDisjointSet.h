@@ -0,0 +1,79 @@
+/* ConcurrentDisjointSet.h
+ * Lock-free disjoint set forest over IDs 0 .. n - 1. Any number of
+ * threads may find and unite sets at the same time.
+ */
+
+#ifndef CONCURRENTDISJOINTSET_H
+#define CONCURRENTDISJOINTSET_H
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+using namespace std;
+
+class ConcurrentDisjointSet {
+    private:
+        /* parent[a] is a's parent in its tree, a itself for roots.
+         * Every link points from a root to a root with a smaller ID, so
+         * concurrent links can't form a cycle.
+         */
+        vector<atomic<uint32_t>> parent;
+
+    public:
+        /* Constructor */
+        ConcurrentDisjointSet(uint32_t n = 0) { assign(n); }
+
+        /* Resize to n IDs, each in a set of its own. Not thread safe. */
+        void assign(uint32_t n) {
+            parent = vector<atomic<uint32_t>>(n);
+            for(uint32_t a = 0; a < n; a++)
+                parent[a].store(a, memory_order_relaxed);
+        }
+
+        uint32_t size() const { return parent.size(); }
+
+        /* Return the root of the set a belongs to. Every node on the way
+         * is pointed at its grandparent by compare-and-swap, splitting
+         * the path for later finds. A failed swap means another thread
+         * already moved the node up, so it is not retried.
+         */
+        uint32_t find(uint32_t a) {
+            while(true) {
+                uint32_t p = parent[a].load();
+                if(p == a)
+                    return a;
+
+                uint32_t grandparent = parent[p].load();
+                if(p != grandparent)
+                    parent[a].compare_exchange_weak(p, grandparent);
+
+                a = p;
+            }
+        }
+
+        /* Union the sets a and b belong to, linking the root with the
+         * larger ID under the other one. Retries if another thread links
+         * that root first.
+         * Return true if they were separate sets, and false otherwise.
+         */
+        bool unite(uint32_t a, uint32_t b) {
+            while(true) {
+                a = find(a);
+                b = find(b);
+                if(a == b)
+                    return false;
+
+                if(a < b)
+                    swap(a, b);
+
+                // Only succeeds while a is still a root
+                uint32_t expected = a;
+                if(parent[a].compare_exchange_strong(expected, b))
+                    return true;
+            }
+        }
+};
+
+#endif // CONCURRENTDISJOINTSET_H
@@ -0,0 +1,110 @@
+/* ConnectionTree.cpp
+ * Union tree with timestamped edges, answering the year in which two
+ * actors become connected after all movies have been processed once.
+ */
+
+#include <limits>
+#include "ConnectionTree.h"
+
+using namespace std;
+
+const uint32_t ConnectionTree::NONE;
+const int ConnectionTree::NOT_CONNECTED;
+
+/* Return the root of the tree actor a belongs to. */
+uint32_t ConnectionTree::findRoot(uint32_t a) const {
+    while(parent[a] != NONE)
+        a = parent[a];
+    return a;
+}
+
+/* Link the trees of actors a and b by a movie released in year,
+ * as the time-th union.
+ * Return true if they were linked, and false if already connected.
+ */
+bool ConnectionTree::unionSet(uint32_t a, uint32_t b, int year, uint32_t time) {
+    a = findRoot(a);
+    b = findRoot(b);
+    if(a == b)
+        return false;
+
+    // Union-by-size, the smaller tree goes under the larger one
+    if(size[a] > size[b])
+        swap(a, b);
+
+    parent[a] = b;
+    size[b] += size[a];
+    linkTime[a] = time;
+    linkYear[a] = year;
+    return true;
+}
+
+/* Build the tree over num_actors actors by processing every movie
+ * of movie_list once, in order. movie_list must be ordered by year.
+ */
+void ConnectionTree::build(const vector<MovieActorList>& movie_list, uint32_t num_actors) {
+    parent.assign(num_actors, NONE);
+    size.assign(num_actors, 1);
+    linkTime.assign(num_actors, numeric_limits<uint32_t>::max());
+    linkYear.assign(num_actors, NOT_CONNECTED);
+
+    firstYear = movie_list.empty() ? NOT_CONNECTED : movie_list.front().year;
+
+    // Connecting every cast member to the first one gives the same sets
+    // as connecting every pair of them
+    uint32_t time = 0;
+    for(auto& item : movie_list) {
+        for(size_t i = 1; i < item.actorList.size(); i++) {
+            if(unionSet(item.actorList[0], item.actorList[i], item.year, time))
+                time++;
+        }
+    }
+}
+
+/* Return the year in which actors a and b become connected, or
+ * NOT_CONNECTED if they never do. Takes O(log n) time.
+ */
+int ConnectionTree::connectedYear(uint32_t a, uint32_t b) const {
+    // Like the up tree, an actor is connected to itself from the first
+    // year on, and so are two missing actors
+    if(a == b)
+        return firstYear;
+
+    if(a == NONE || b == NONE)
+        return NOT_CONNECTED;
+
+    // a and b become connected by the latest link on the tree path between
+    // them. Always climbing the side with the earlier link never passes
+    // their lowest common ancestor, whose link is later than every link
+    // below it, so the last link climbed is the latest one on the path.
+    int year = NOT_CONNECTED;
+    while(a != b) {
+        uint32_t& lower = linkTime[a] < linkTime[b] ? a : b;
+
+        // Both are roots of different trees
+        if(parent[lower] == NONE)
+            return NOT_CONNECTED;
+
+        year = linkYear[lower];
+        lower = parent[lower];
+    }
+
+    return year;
+}
+
+/* Run actorconnections algorithm on list of src and dst pairs,
+ * looking actors up in names.
+ * Return vector of actorconnections data for each input pair.
+ */
+vector<string> ConnectionTree::actorConnections(const StringTable& names,
+    const vector<string>& src, const vector<string>& dst) const {
+    vector<string> output;
+    output.reserve(src.size());
+
+    for(size_t i = 0; i < src.size(); i++) {
+        int year = connectedYear(names.find(src[i]), names.find(dst[i]));
+        output.push_back(src[i] + '\t' + dst[i] + '\t' + to_string(year));
+    }
+
+    return output;
+}
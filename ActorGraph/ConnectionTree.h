@@ -0,0 +1,70 @@
+/* ConnectionTree.h
+ * Union tree with timestamped edges, answering the year in which two
+ * actors become connected after all movies have been processed once.
+ */
+
+#ifndef CONNECTIONTREE_H
+#define CONNECTIONTREE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "MovieActorList.h"
+#include "StringTable.h"
+
+using namespace std;
+
+class ConnectionTree {
+    private:
+        /* Up tree linked by union-by-size without path compression, so
+         * every tree is O(log n) deep and keeps the order of its unions.
+         * A root a was linked under parent[a] by the linkTime[a]-th union,
+         * made by a movie released in linkYear[a]. Link times strictly
+         * increase and link years never decrease on the way up a tree.
+         */
+        vector<uint32_t> parent;
+        vector<uint32_t> size;
+        vector<uint32_t> linkTime;
+        vector<int> linkYear;
+
+        /* Year of the first movie, in which an actor is connected to itself */
+        int firstYear;
+
+        /* Return the root of the tree actor a belongs to. */
+        uint32_t findRoot(uint32_t a) const;
+
+        /* Link the trees of actors a and b by a movie released in year,
+         * as the time-th union.
+         * Return true if they were linked, and false if already connected.
+         */
+        bool unionSet(uint32_t a, uint32_t b, int year, uint32_t time);
+
+    public:
+        /* Marks a missing actor, and the parent of a root */
+        static const uint32_t NONE = StringTable::NONE;
+
+        /* Year reported for actors that never become connected */
+        static const int NOT_CONNECTED = 9999;
+
+        /* Constructor */
+        ConnectionTree() : firstYear(NOT_CONNECTED) {}
+
+        /* Build the tree over num_actors actors by processing every movie
+         * of movie_list once, in order. movie_list must be ordered by year.
+         */
+        void build(const vector<MovieActorList>& movie_list, uint32_t num_actors);
+
+        /* Return the year in which actors a and b become connected, or
+         * NOT_CONNECTED if they never do. Takes O(log n) time.
+         */
+        int connectedYear(uint32_t a, uint32_t b) const;
+
+        /* Run actorconnections algorithm on list of src and dst pairs,
+         * looking actors up in names.
+         * Return vector of actorconnections data for each input pair.
+         */
+        vector<string> actorConnections(const StringTable& names,
+            const vector<string>& src, const vector<string>& dst) const;
+};
+
+#endif // CONNECTIONTREE_H
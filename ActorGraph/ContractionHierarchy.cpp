@@ -0,0 +1,443 @@
+/* ContractionHierarchy.cpp
+ * Contraction hierarchy over the actors and movies of a frozen Actor
+ * Graph, answering weighted path queries with a bidirectional search
+ * that only climbs to more important nodes.
+ */
+
+#include <algorithm>
+#include <queue>
+#include <limits>
+#include <functional>
+#include "ContractionHierarchy.h"
+#include "ActorGraph.h"
+#include "SearchWorkspace.h"
+
+using namespace std;
+
+const uint32_t ContractionHierarchy::NONE;
+const unsigned ContractionHierarchy::WITNESS_SETTLE_LIMIT;
+const unsigned ContractionHierarchy::SIMULATION_SETTLE_LIMIT;
+
+typedef pair<int, uint32_t> QueueEntry;
+typedef priority_queue<QueueEntry, vector<QueueEntry>, greater<QueueEntry>> MinQueue;
+
+/* Edge of the graph being contracted */
+struct HierarchyEdge {
+    uint32_t to;
+    int weight;
+    uint32_t middle;    // Node bypassed by a shortcut, NONE for original edges
+};
+
+/* Contraction state. Contracted nodes are removed from adj, so adj only
+ * holds edges between nodes not contracted yet.
+ */
+struct HierarchyBuilder {
+    vector<vector<HierarchyEdge>> adj;
+    vector<vector<HierarchyEdge>> up;
+    vector<int> deletedNeighbours;
+
+    /* Witness search state, cleared through witnessTouched. Targets are
+     * the nodes the search is looking for witnesses to.
+     */
+    vector<int> witnessDistance;
+    vector<uint32_t> witnessTouched;
+    vector<bool> witnessTarget;
+    vector<QueueEntry> witnessQueue;
+
+    HierarchyBuilder(uint32_t num_nodes) :
+        adj(num_nodes),
+        up(num_nodes),
+        deletedNeighbours(num_nodes, 0),
+        witnessDistance(num_nodes, numeric_limits<int>::max()),
+        witnessTarget(num_nodes, false) {}
+
+    /* Add an edge between a and b, or lower the weight of an existing one. */
+    void addEdge(uint32_t a, uint32_t b, int weight, uint32_t middle) {
+        for(auto& e : adj[a]) {
+            if(e.to == b) {
+                if(weight < e.weight) {
+                    e.weight = weight;
+                    e.middle = middle;
+                    for(auto& back : adj[b]) {
+                        if(back.to == a) {
+                            back.weight = weight;
+                            back.middle = middle;
+                        }
+                    }
+                }
+                return;
+            }
+        }
+
+        adj[a].push_back({b, weight, middle});
+        adj[b].push_back({a, weight, middle});
+    }
+
+    /* Run Dijkstra's algorithm from src avoiding skip, filling
+     * witnessDistance, until num_targets targets are settled or after
+     * max_cost or settle_limit settled nodes.
+     */
+    void witnessSearch(uint32_t src, uint32_t skip, int max_cost, size_t num_targets,
+        unsigned settle_limit) {
+        // Min-heap kept in witnessQueue to reuse its storage
+        vector<QueueEntry>& pq = witnessQueue;
+        pq.clear();
+        witnessDistance[src] = 0;
+        witnessTouched.push_back(src);
+        pq.push_back(make_pair(0, src));
+
+        unsigned settled = 0;
+        while(!pq.empty() && settled < settle_limit) {
+            pop_heap(pq.begin(), pq.end(), greater<QueueEntry>());
+            int d = pq.back().first;
+            uint32_t curr = pq.back().second;
+            pq.pop_back();
+
+            if(d > witnessDistance[curr])
+                continue;
+            if(d > max_cost)
+                break;
+            settled++;
+
+            if(witnessTarget[curr] && --num_targets == 0)
+                break;
+
+            for(auto& e : adj[curr]) {
+                if(e.to == skip)
+                    continue;
+
+                int c = d + e.weight;
+                if(c < witnessDistance[e.to]) {
+                    if(witnessDistance[e.to] == numeric_limits<int>::max())
+                        witnessTouched.push_back(e.to);
+                    witnessDistance[e.to] = c;
+                    pq.push_back(make_pair(c, e.to));
+                    push_heap(pq.begin(), pq.end(), greater<QueueEntry>());
+                }
+            }
+        }
+    }
+
+    /* Reset witnessDistance after a witness search. */
+    void clearWitness() {
+        for(uint32_t v : witnessTouched)
+            witnessDistance[v] = numeric_limits<int>::max();
+        witnessTouched.clear();
+    }
+
+    /* Contract v, adding a shortcut between each pair of its neighbours
+     * whose shortest path runs through v. With simulate, only count them.
+     * Return the number of shortcuts needed.
+     */
+    size_t contract(uint32_t v, bool simulate) {
+        // Shortcuts only change the edges of v's neighbours, not v's own
+        const vector<HierarchyEdge>& neighbours = adj[v];
+        size_t shortcuts = 0;
+
+        for(size_t i = 0; i + 1 < neighbours.size(); i++) {
+            int max_cost = 0;
+            for(size_t j = i + 1; j < neighbours.size(); j++)
+                max_cost = max(max_cost, neighbours[i].weight + neighbours[j].weight);
+
+            for(size_t j = i + 1; j < neighbours.size(); j++)
+                witnessTarget[neighbours[j].to] = true;
+            witnessSearch(neighbours[i].to, v, max_cost, neighbours.size() - i - 1,
+                simulate ? ContractionHierarchy::SIMULATION_SETTLE_LIMIT
+                    : ContractionHierarchy::WITNESS_SETTLE_LIMIT);
+
+            for(size_t j = i + 1; j < neighbours.size(); j++) {
+                witnessTarget[neighbours[j].to] = false;
+                int cost = neighbours[i].weight + neighbours[j].weight;
+                if(witnessDistance[neighbours[j].to] > cost) {
+                    shortcuts++;
+                    if(!simulate)
+                        addEdge(neighbours[i].to, neighbours[j].to, cost, v);
+                }
+            }
+            clearWitness();
+        }
+
+        if(simulate)
+            return shortcuts;
+
+        // Its remaining edges all lead to nodes contracted later
+        up[v] = adj[v];
+        for(auto& e : adj[v]) {
+            auto& back = adj[e.to];
+            for(size_t k = 0; k < back.size(); k++) {
+                if(back[k].to == v) {
+                    back[k] = back.back();
+                    back.pop_back();
+                    break;
+                }
+            }
+            deletedNeighbours[e.to]++;
+        }
+        vector<HierarchyEdge>().swap(adj[v]);
+
+        return shortcuts;
+    }
+
+    /* Return the contraction priority of v, lowest first. */
+    int priority(uint32_t v) {
+        return (int)contract(v, true) - (int)adj[v].size() + deletedNeighbours[v];
+    }
+};
+
+/* Contract every node of the graph, least important first, adding
+ * shortcuts that keep shortest path costs between the rest.
+ * Importance is the edge difference, shortcuts added minus edges
+ * removed, plus the number of neighbours already contracted.
+ * The graph must be frozen and have no negative weights.
+ * Return true if the hierarchy was built, and false otherwise.
+ */
+bool ContractionHierarchy::build(const ActorGraph& graph) {
+    if(!graph.isFrozen())
+        return false;
+
+    CSRView csr = graph.csrView();
+    for(int weight : csr.movieWeight) {
+        if(weight < 0)
+            return false;
+    }
+
+    uint32_t num_actors = graph.numActors();
+    uint32_t num_movies = graph.numMovies();
+    uint32_t num_nodes = num_actors + num_movies;
+    HierarchyBuilder builder(num_nodes);
+
+    // Join each movie to its cast, once per actor
+    vector<uint32_t> lastMovie(num_actors, NONE);
+    for(uint32_t m = 0; m < num_movies; m++) {
+        for(uint32_t j = csr.movieOffsets[m]; j < csr.movieOffsets[m + 1]; j++) {
+            uint32_t actor = csr.movieActors[j];
+            if(lastMovie[actor] == m)
+                continue;
+            lastMovie[actor] = m;
+
+            builder.adj[actor].push_back({num_actors + m, csr.movieWeight[m], NONE});
+            builder.adj[num_actors + m].push_back({actor, csr.movieWeight[m], NONE});
+        }
+    }
+
+    // Contract in order of priority, updated lazily: a node whose priority
+    // went up since it was queued goes back in the queue
+    vector<int> priority(num_nodes);
+    MinQueue pq;
+    for(uint32_t v = 0; v < num_nodes; v++) {
+        priority[v] = builder.priority(v);
+        pq.push(make_pair(priority[v], v));
+    }
+
+    vector<bool> contracted(num_nodes, false);
+    while(!pq.empty()) {
+        uint32_t v = pq.top().second;
+        int queued = pq.top().first;
+        pq.pop();
+
+        if(contracted[v] || queued != priority[v])
+            continue;
+
+        priority[v] = builder.priority(v);
+        if(!pq.empty() && priority[v] > pq.top().first) {
+            pq.push(make_pair(priority[v], v));
+            continue;
+        }
+
+        builder.contract(v, false);
+        contracted[v] = true;
+    }
+
+    // Compact the upward edges into CSR form
+    ownOffsets.assign(num_nodes + 1, 0);
+    for(uint32_t v = 0; v < num_nodes; v++)
+        ownOffsets[v + 1] = ownOffsets[v] + builder.up[v].size();
+
+    ownTargets.resize(ownOffsets[num_nodes]);
+    ownWeights.resize(ownOffsets[num_nodes]);
+    ownMiddles.resize(ownOffsets[num_nodes]);
+    for(uint32_t v = 0; v < num_nodes; v++) {
+        uint32_t pos = ownOffsets[v];
+        for(auto& e : builder.up[v]) {
+            ownTargets[pos] = e.to;
+            ownWeights[pos] = e.weight;
+            ownMiddles[pos] = e.middle;
+            pos++;
+        }
+    }
+
+    numActors = num_actors;
+    upOffsets = ownOffsets;
+    upTargets = ownTargets;
+    upWeights = ownWeights;
+    upMiddles = ownMiddles;
+    return true;
+}
+
+/* Use upward graph arrays stored elsewhere, such as in a snapshot,
+ * for a graph of num_actors actors and num_movies movies.
+ * Return true if the arrays are consistent, and false otherwise.
+ */
+bool ContractionHierarchy::attach(ArrayView<uint32_t> offsets, ArrayView<uint32_t> targets,
+    ArrayView<int> weights, ArrayView<uint32_t> middles,
+    uint32_t num_actors, uint32_t num_movies) {
+    uint32_t num_nodes = num_actors + num_movies;
+    if(offsets.size() != (size_t)num_nodes + 1 || offsets[num_nodes] != targets.size()
+        || weights.size() != targets.size() || middles.size() != targets.size())
+        return false;
+
+    for(uint32_t v = 0; v < num_nodes; v++) {
+        if(offsets[v] > offsets[v + 1])
+            return false;
+    }
+
+    for(size_t i = 0; i < targets.size(); i++) {
+        if(targets[i] >= num_nodes || (middles[i] != NONE && middles[i] >= num_nodes))
+            return false;
+    }
+
+    numActors = num_actors;
+    upOffsets = offsets;
+    upTargets = targets;
+    upWeights = weights;
+    upMiddles = middles;
+    return true;
+}
+
+/* Return the index of the upward edge between a and b. */
+uint32_t ContractionHierarchy::findEdge(uint32_t a, uint32_t b) const {
+    for(uint32_t i = upOffsets[a]; i < upOffsets[a + 1]; i++) {
+        if(upTargets[i] == b)
+            return i;
+    }
+
+    for(uint32_t i = upOffsets[b]; i < upOffsets[b + 1]; i++) {
+        if(upTargets[i] == a)
+            return i;
+    }
+
+    return NONE;
+}
+
+/* Append the original nodes of the edge from a to b to nodes,
+ * excluding a, expanding shortcuts recursively.
+ */
+void ContractionHierarchy::unpackEdge(uint32_t a, uint32_t b, vector<uint32_t>& nodes) const {
+    uint32_t middle = upMiddles[findEdge(a, b)];
+    if(middle == NONE) {
+        nodes.push_back(b);
+        return;
+    }
+
+    unpackEdge(a, middle, nodes);
+    unpackEdge(middle, b, nodes);
+}
+
+/* Find a shortest weighted path from actor src to actor dst.
+ * Fill path with its actors and pathMovies with the movies between
+ * them.
+ * ws holds the search state, so queries with different workspaces
+ * can run concurrently.
+ * Return false if src or dst node doesn't exist, or if dst can't be
+ * reached from src.
+ */
+bool ContractionHierarchy::query(SearchWorkspace& ws, uint32_t src, uint32_t dst,
+    vector<uint32_t>& path, vector<uint32_t>& pathMovies) const {
+    path.clear();
+    pathMovies.clear();
+    if(!isBuilt() || src == NONE || dst == NONE)
+        return false;
+
+    uint32_t num_nodes = upOffsets.size() - 1;
+    for(int side = 0; side < 2; side++) {
+        if(ws.upDistance[side].size() != num_nodes) {
+            ws.upDistance[side].assign(num_nodes, numeric_limits<int>::max());
+            ws.upPrev[side].assign(num_nodes, NONE);
+        }
+    }
+
+    // Search upwards from src (side 0) and from dst (side 1) at once,
+    // until neither side can improve on the best meeting node
+    MinQueue pq[2];
+    uint32_t ends[2] = {src, dst};
+    for(int side = 0; side < 2; side++) {
+        ws.upDistance[side][ends[side]] = 0;
+        ws.upTouched.push_back(ends[side]);
+        pq[side].push(make_pair(0, ends[side]));
+    }
+
+    int best = numeric_limits<int>::max();
+    uint32_t meet = NONE;
+    while(true) {
+        for(int side = 0; side < 2; side++) {
+            if(!pq[side].empty() && pq[side].top().first >= best)
+                pq[side] = MinQueue();
+        }
+        if(pq[0].empty() && pq[1].empty())
+            break;
+
+        int side = (pq[1].empty() || (!pq[0].empty() && pq[0].top() <= pq[1].top())) ? 0 : 1;
+        int d = pq[side].top().first;
+        uint32_t curr = pq[side].top().second;
+        pq[side].pop();
+
+        vector<int>& distance = ws.upDistance[side];
+        if(d > distance[curr])
+            continue;
+
+        int other = ws.upDistance[1 - side][curr];
+        if(other != numeric_limits<int>::max() && d + other < best) {
+            best = d + other;
+            meet = curr;
+        }
+
+        for(uint32_t i = upOffsets[curr]; i < upOffsets[curr + 1]; i++) {
+            uint32_t next = upTargets[i];
+            int c = d + upWeights[i];
+            if(c < distance[next]) {
+                if(ws.upDistance[0][next] == numeric_limits<int>::max()
+                    && ws.upDistance[1][next] == numeric_limits<int>::max())
+                    ws.upTouched.push_back(next);
+                distance[next] = c;
+                ws.upPrev[side][next] = curr;
+                pq[side].push(make_pair(c, next));
+            }
+        }
+    }
+
+    // Unpack the path src -> meet -> dst into original nodes, which
+    // alternate between actors and movies
+    vector<uint32_t> nodes;
+    if(meet != NONE) {
+        vector<uint32_t> up;
+        for(uint32_t v = meet; v != src; v = ws.upPrev[0][v])
+            up.push_back(v);
+
+        nodes.push_back(src);
+        uint32_t prev = src;
+        for(auto it = up.rbegin(); it != up.rend(); ++it) {
+            unpackEdge(prev, *it, nodes);
+            prev = *it;
+        }
+        for(uint32_t v = meet; v != dst; v = ws.upPrev[1][v])
+            unpackEdge(v, ws.upPrev[1][v], nodes);
+    }
+
+    for(size_t i = 0; i < nodes.size(); i++) {
+        if(i % 2 == 0)
+            path.push_back(nodes[i]);
+        else
+            pathMovies.push_back(nodes[i] - numActors);
+    }
+
+    // Leave the search state cleared for the next query
+    for(uint32_t v : ws.upTouched) {
+        for(int side = 0; side < 2; side++) {
+            ws.upDistance[side][v] = numeric_limits<int>::max();
+            ws.upPrev[side][v] = NONE;
+        }
+    }
+    ws.upTouched.clear();
+
+    return meet != NONE;
+}
@@ -0,0 +1,108 @@
+/* ContractionHierarchy.h
+ * Contraction hierarchy over the actors and movies of a frozen Actor
+ * Graph, answering weighted path queries with a bidirectional search
+ * that only climbs to more important nodes.
+ *
+ * The hierarchy is built on the bipartite graph, where actor a and
+ * movie m are joined by an edge of weight w(m) in both directions, so
+ * a path costs twice its weight in the Actor Graph. Node IDs are actor
+ * IDs followed by numActors + movie ID.
+ */
+
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <vector>
+#include <cstdint>
+#include "ArrayView.h"
+
+using namespace std;
+
+class ActorGraph;
+struct SearchWorkspace;
+
+class ContractionHierarchy {
+    private:
+        uint32_t numActors;
+
+        /* Upward graph in CSR form. Node v's edges to nodes contracted
+         * after it are upTargets[upOffsets[v] .. upOffsets[v + 1]), with
+         * their weights, and the node a shortcut bypasses as its middle,
+         * NONE for edges of the original graph. The arrays either view
+         * the own* vectors or a snapshot.
+         */
+        ArrayView<uint32_t> upOffsets;
+        ArrayView<uint32_t> upTargets;
+        ArrayView<int> upWeights;
+        ArrayView<uint32_t> upMiddles;
+
+        vector<uint32_t> ownOffsets;
+        vector<uint32_t> ownTargets;
+        vector<int> ownWeights;
+        vector<uint32_t> ownMiddles;
+
+        /* Return the index of the upward edge between a and b. */
+        uint32_t findEdge(uint32_t a, uint32_t b) const;
+
+        /* Append the original nodes of the edge from a to b to nodes,
+         * excluding a, expanding shortcuts recursively.
+         */
+        void unpackEdge(uint32_t a, uint32_t b, vector<uint32_t>& nodes) const;
+
+    public:
+        /* Marks an original edge, and a missing node */
+        static const uint32_t NONE = 0xFFFFFFFF;
+
+        /* Nodes settled by each witness search while contracting, and while
+         * estimating the shortcuts of a node for its priority. Bounds
+         * preprocessing time at the cost of some extra shortcuts.
+         */
+        static const unsigned WITNESS_SETTLE_LIMIT = 500;
+        static const unsigned SIMULATION_SETTLE_LIMIT = 50;
+
+        /* Constructor */
+        ContractionHierarchy() : numActors(0) {}
+
+        /* The views point into the hierarchy itself, so it can't be copied */
+        ContractionHierarchy(const ContractionHierarchy&) = delete;
+        ContractionHierarchy& operator=(const ContractionHierarchy&) = delete;
+
+        /* Contract every node of the graph, least important first, adding
+         * shortcuts that keep shortest path costs between the rest.
+         * Importance is the edge difference, shortcuts added minus edges
+         * removed, plus the number of neighbours already contracted.
+         * The graph must be frozen and have no negative weights.
+         * Return true if the hierarchy was built, and false otherwise.
+         */
+        bool build(const ActorGraph& graph);
+
+        /* Use upward graph arrays stored elsewhere, such as in a snapshot,
+         * for a graph of num_actors actors and num_movies movies.
+         * Return true if the arrays are consistent, and false otherwise.
+         */
+        bool attach(ArrayView<uint32_t> offsets, ArrayView<uint32_t> targets,
+            ArrayView<int> weights, ArrayView<uint32_t> middles,
+            uint32_t num_actors, uint32_t num_movies);
+
+        /* Return true if the hierarchy has been built or attached. */
+        bool isBuilt() const { return !upOffsets.empty(); }
+
+        /* Return the upward graph arrays, for saving. */
+        ArrayView<uint32_t> offsetArray() const { return upOffsets; }
+        ArrayView<uint32_t> targetArray() const { return upTargets; }
+        ArrayView<int> weightArray() const { return upWeights; }
+        ArrayView<uint32_t> middleArray() const { return upMiddles; }
+
+        /* Find a shortest weighted path from actor src to actor dst.
+         * Fill path with its actors and pathMovies with the movies between
+         * them.
+         * ws holds the search state, so queries with different workspaces
+         * can run concurrently.
+         * Return false if src or dst node doesn't exist, or if dst can't be
+         * reached from src.
+         */
+        bool query(SearchWorkspace& ws, uint32_t src, uint32_t dst, vector<uint32_t>& path,
+            vector<uint32_t>& pathMovies) const;
+};
+
+#endif // CONTRACTIONHIERARCHY_H
@@ -0,0 +1,147 @@
+/* DirectionOptimizingBFS.cpp
+ * Whole-graph Breadth First Search on the CSR arrays of a frozen Actor
+ * Graph that switches between top-down and bottom-up steps.
+ */
+
+#include <algorithm>
+#include "DirectionOptimizingBFS.h"
+#include "util.h"
+
+using namespace std;
+
+const int DirectionOptimizingBFS::ALPHA;
+const int DirectionOptimizingBFS::BETA;
+
+/* Constructor, allocating search state for every actor and movie */
+DirectionOptimizingBFS::DirectionOptimizingBFS(const CSRView& graph) :
+    graph(graph),
+    distance(graph.numActors(), numeric_limits<int>::max()),
+    visited(graph.numActors()),
+    frontier(graph.numActors()),
+    next(graph.numActors()),
+    movieVisited(graph.numMovies()),
+    movieFrontier(graph.numMovies()) {}
+
+/* Expand the frontier at depth by walking from each frontier actor
+ * through its movies to their cast.
+ * Return the number of actors reached and add their links to next_edges.
+ */
+uint32_t DirectionOptimizingBFS::topDownStep(int depth, int max_year, uint64_t& next_edges) {
+    uint32_t reached = 0;
+
+    frontier.forEach([&](size_t curr) {
+        for(uint32_t i = graph.actorOffsets[curr]; i < graph.actorOffsets[curr + 1]; i++) {
+            uint32_t movie = graph.actorMovies[i];
+            if(movieVisited.test(movie) || graph.movieYear[movie] > max_year)
+                continue;
+            movieVisited.set(movie);
+
+            for(uint32_t j = graph.movieOffsets[movie]; j < graph.movieOffsets[movie + 1]; j++) {
+                uint32_t actor = graph.movieActors[j];
+                if(visited.test(actor))
+                    continue;
+
+                visited.set(actor);
+                next.set(actor);
+                distance[actor] = depth + 1;
+                next_edges += graph.actorOffsets[actor + 1] - graph.actorOffsets[actor];
+                reached++;
+            }
+        }
+    });
+
+    return reached;
+}
+
+/* Expand the frontier at depth by checking each movie not yet reached
+ * for a frontier actor in its cast, then each actor not yet reached
+ * for a movie found that way.
+ * Return the number of actors reached and add their links to next_edges.
+ */
+uint32_t DirectionOptimizingBFS::bottomUpStep(int depth, int max_year, uint64_t& next_edges) {
+    uint32_t reached = 0;
+
+    // A movie is reached by this level if any of its cast is in the frontier
+    movieFrontier.clear();
+    movieVisited.forEachClear([&](size_t movie) {
+        if(graph.movieYear[movie] > max_year)
+            return;
+
+        for(uint32_t j = graph.movieOffsets[movie]; j < graph.movieOffsets[movie + 1]; j++) {
+            if(frontier.test(graph.movieActors[j])) {
+                movieVisited.set(movie);
+                movieFrontier.set(movie);
+                break;
+            }
+        }
+    });
+
+    // An actor is reached if any of its movies was reached by this level
+    visited.forEachClear([&](size_t actor) {
+        for(uint32_t i = graph.actorOffsets[actor]; i < graph.actorOffsets[actor + 1]; i++) {
+            if(movieFrontier.test(graph.actorMovies[i])) {
+                visited.set(actor);
+                next.set(actor);
+                distance[actor] = depth + 1;
+                next_edges += graph.actorOffsets[actor + 1] - graph.actorOffsets[actor];
+                reached++;
+                break;
+            }
+        }
+    });
+
+    return reached;
+}
+
+/* Run BFS from src over the whole graph, following only movies
+ * released in or before max_year.
+ * Return the distance of every actor from src in movie hops,
+ * INT_MAX for actors that can't be reached.
+ */
+const vector<int>& DirectionOptimizingBFS::bfsAll(uint32_t src, int max_year) {
+    fill(distance.begin(), distance.end(), numeric_limits<int>::max());
+    visited.clear();
+    frontier.clear();
+    movieVisited.clear();
+    levels.clear();
+
+    uint32_t num_actors = graph.numActors();
+    if(src >= num_actors)
+        return distance;
+
+    distance[src] = 0;
+    visited.set(src);
+    frontier.set(src);
+
+    // Links of the frontier and of the actors not reached yet
+    uint64_t frontier_edges = graph.actorOffsets[src + 1] - graph.actorOffsets[src];
+    uint64_t unvisited_edges = graph.actorMovies.size() - frontier_edges;
+    uint32_t frontier_size = 1;
+    bool bottom_up = false;
+
+    Timer timer;
+    for(int depth = 0; frontier_size > 0; depth++) {
+        if(!bottom_up && frontier_edges > unvisited_edges / ALPHA)
+            bottom_up = true;
+        else if(bottom_up && frontier_size < num_actors / BETA)
+            bottom_up = false;
+
+        timer.begin_timer();
+        next.clear();
+        uint64_t next_edges = 0;
+        uint32_t reached;
+        if(bottom_up)
+            reached = bottomUpStep(depth, max_year, next_edges);
+        else
+            reached = topDownStep(depth, max_year, next_edges);
+        frontier.swap(next);
+
+        levels.push_back({depth, frontier_size, frontier_edges, bottom_up, timer.end_timer()});
+
+        frontier_size = reached;
+        frontier_edges = next_edges;
+        unvisited_edges -= next_edges;
+    }
+
+    return distance;
+}
@@ -0,0 +1,81 @@
+/* DirectionOptimizingBFS.h
+ * Whole-graph Breadth First Search on the CSR arrays of a frozen Actor
+ * Graph that switches between top-down and bottom-up steps.
+ */
+
+#ifndef DIRECTIONOPTIMIZINGBFS_H
+#define DIRECTIONOPTIMIZINGBFS_H
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include "Bitmap.h"
+#include "CSRView.h"
+
+using namespace std;
+
+/* Statistics of one level of a BFS */
+struct BFSLevel {
+    int depth;               // Distance of the frontier actors from src
+    uint32_t frontierSize;   // Number of actors in the frontier
+    uint64_t frontierEdges;  // Number of actor-movie links of the frontier
+    bool bottomUp;           // True if the level was expanded bottom-up
+    long long nanoseconds;   // Time spent expanding the level
+};
+
+class DirectionOptimizingBFS {
+    private:
+        CSRView graph;
+
+        /* Distance of each actor from src in movie hops, INT_MAX if unreached */
+        vector<int> distance;
+
+        /* Actors reached so far, in the current level and in the next one */
+        Bitmap visited;
+        Bitmap frontier;
+        Bitmap next;
+
+        /* Movies whose cast has been reached, and those reached by the
+         * current level during a bottom-up step
+         */
+        Bitmap movieVisited;
+        Bitmap movieFrontier;
+
+        vector<BFSLevel> levels;
+
+        /* Expand the frontier at depth by walking from each frontier actor
+         * through its movies to their cast.
+         * Return the number of actors reached and add their links to next_edges.
+         */
+        uint32_t topDownStep(int depth, int max_year, uint64_t& next_edges);
+
+        /* Expand the frontier at depth by checking each movie not yet reached
+         * for a frontier actor in its cast, then each actor not yet reached
+         * for a movie found that way.
+         * Return the number of actors reached and add their links to next_edges.
+         */
+        uint32_t bottomUpStep(int depth, int max_year, uint64_t& next_edges);
+
+    public:
+        /* Switch to bottom-up once the frontier has more than 1 / ALPHA of
+         * the links of the actors not reached yet, and back to top-down
+         * once it holds fewer than 1 / BETA of all actors.
+         */
+        static const int ALPHA = 14;
+        static const int BETA = 24;
+
+        /* Constructor, allocating search state for every actor and movie */
+        DirectionOptimizingBFS(const CSRView& graph);
+
+        /* Run BFS from src over the whole graph, following only movies
+         * released in or before max_year.
+         * Return the distance of every actor from src in movie hops,
+         * INT_MAX for actors that can't be reached.
+         */
+        const vector<int>& bfsAll(uint32_t src, int max_year = numeric_limits<int>::max());
+
+        /* Return the statistics of each level of the last bfsAll. */
+        const vector<BFSLevel>& levelStats() const { return levels; }
+};
+
+#endif // DIRECTIONOPTIMIZINGBFS_H
@@ -0,0 +1,73 @@
+/* DisjointSet.h
+ * Flat array disjoint set forest over IDs 0 .. n - 1, with union-by-size
+ * and path halving. Finding and uniting sets never allocates.
+ */
+
+#ifndef DISJOINTSET_H
+#define DISJOINTSET_H
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+using namespace std;
+
+class DisjointSet {
+    private:
+        /* parent[a] is a's parent in its tree, a itself for roots.
+         * setSize[r] is the number of IDs in the set of root r.
+         */
+        vector<uint32_t> parent;
+        vector<uint32_t> setSize;
+
+    public:
+        /* Constructor */
+        DisjointSet(uint32_t n = 0) { assign(n); }
+
+        /* Resize to n IDs, each in a set of its own. */
+        void assign(uint32_t n) {
+            parent.resize(n);
+            for(uint32_t a = 0; a < n; a++)
+                parent[a] = a;
+            setSize.assign(n, 1);
+        }
+
+        /* Add ID size() in a set of its own. */
+        void add() {
+            parent.push_back(parent.size());
+            setSize.push_back(1);
+        }
+
+        uint32_t size() const { return parent.size(); }
+
+        /* Return the root of the set a belongs to. Every node on the way
+         * is pointed at its grandparent, halving the path for later finds.
+         */
+        uint32_t find(uint32_t a) {
+            while(parent[a] != a) {
+                parent[a] = parent[parent[a]];
+                a = parent[a];
+            }
+            return a;
+        }
+
+        /* Union the sets a and b belong to, the smaller set going under
+         * the root of the larger one.
+         * Return true if they were separate sets, and false otherwise.
+         */
+        bool unite(uint32_t a, uint32_t b) {
+            a = find(a);
+            b = find(b);
+            if(a == b)
+                return false;
+
+            if(setSize[a] > setSize[b])
+                swap(a, b);
+
+            parent[a] = b;
+            setSize[b] += setSize[a];
+            return true;
+        }
+};
+
+#endif // DISJOINTSET_H
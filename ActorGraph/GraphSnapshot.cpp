@@ -0,0 +1,96 @@
+/* GraphSnapshot.cpp
+ * Versioned binary snapshot file of a frozen Actor Graph.
+ */
+
+#include <fstream>
+#include <cstring>
+#include "GraphSnapshot.h"
+
+using namespace std;
+
+static const char SNAPSHOT_MAGIC[8] = {'A', 'C', 'T', 'G', 'R', 'A', 'P', 'H'};
+
+/* Round offset up to the next 8 byte boundary */
+static uint64_t align8(uint64_t offset) {
+    return (offset + 7) & ~(uint64_t)7;
+}
+
+/* Write the snapshot to filename.
+ * Return true if the file was written successfully, and false otherwise.
+ */
+bool SnapshotWriter::write(const char* filename) {
+    SnapshotHeader header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.flags = flags;
+    header.numSections = sections.size();
+    header.reserved = 0;
+
+    // Lay out the section data after the section table
+    uint64_t offset = sizeof(SnapshotHeader) + sections.size() * sizeof(SnapshotSection);
+    for(auto& s : sections) {
+        offset = align8(offset);
+        s.info.offset = offset;
+        offset += s.info.count * s.info.elementSize;
+    }
+
+    ofstream outfile(filename, ios::binary | ios::trunc);
+    if(!outfile)
+        return false;
+
+    outfile.write((const char*)&header, sizeof(header));
+    for(auto& s : sections)
+        outfile.write((const char*)&s.info, sizeof(s.info));
+
+    static const char padding[8] = {0};
+    uint64_t pos = sizeof(SnapshotHeader) + sections.size() * sizeof(SnapshotSection);
+    for(auto& s : sections) {
+        outfile.write(padding, s.info.offset - pos);
+        outfile.write((const char*)s.data, s.info.count * s.info.elementSize);
+        pos = s.info.offset + s.info.count * s.info.elementSize;
+    }
+
+    outfile.close();
+    return !outfile.fail();
+}
+
+/* Map filename and check its header and section table.
+ * Return true if it is a valid snapshot, and false otherwise.
+ */
+bool SnapshotFile::open(const char* filename) {
+    if(!file.open(filename))
+        return false;
+
+    if(file.size() < sizeof(SnapshotHeader))
+        return false;
+
+    header = (const SnapshotHeader*)file.data();
+    if(memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0
+        || header->version != SNAPSHOT_VERSION)
+        return false;
+
+    uint64_t table_end = sizeof(SnapshotHeader) + (uint64_t)header->numSections * sizeof(SnapshotSection);
+    if(table_end > file.size())
+        return false;
+
+    sections = (const SnapshotSection*)(file.data() + sizeof(SnapshotHeader));
+
+    // Every section must be aligned and lie inside the file
+    for(uint32_t i = 0; i < header->numSections; i++) {
+        const SnapshotSection& s = sections[i];
+        if(s.offset % 8 != 0 || s.offset < table_end || s.offset > file.size() || s.elementSize == 0
+            || s.count > (file.size() - s.offset) / s.elementSize)
+            return false;
+    }
+
+    return true;
+}
+
+/* Return the section with the given ID, or nullptr if missing. */
+const SnapshotSection* SnapshotFile::findSection(uint32_t id, uint32_t elementSize) const {
+    for(uint32_t i = 0; i < header->numSections; i++) {
+        if(sections[i].id == id)
+            return sections[i].elementSize == elementSize ? &sections[i] : nullptr;
+    }
+    return nullptr;
+}
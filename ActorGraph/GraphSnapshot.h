@@ -0,0 +1,132 @@
+/* GraphSnapshot.h
+ * Versioned binary snapshot file of a frozen Actor Graph.
+ *
+ * Layout (native byte order):
+ *     SnapshotHeader
+ *     SnapshotSection[header.numSections]
+ *     section data, each section starting on an 8 byte boundary
+ *
+ * A snapshot is mapped read-only and its arrays are used in place, so
+ * loading it doesn't parse or copy the graph, and processes mapping the
+ * same snapshot share its pages in the page cache.
+ */
+
+#ifndef GRAPHSNAPSHOT_H
+#define GRAPHSNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+#include "ArrayView.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+/* Bump when the meaning of existing sections changes */
+static const uint32_t SNAPSHOT_VERSION = 1;
+
+/* Header flags */
+static const uint32_t SNAPSHOT_WEIGHTED = 1; // movieWeights use 1 + (2015 - year)
+
+/* Section IDs. New optional sections may be added without a version bump. */
+enum SnapshotSectionId : uint32_t {
+    SECTION_ACTOR_OFFSETS = 1,
+    SECTION_ACTOR_MOVIES,
+    SECTION_MOVIE_OFFSETS,
+    SECTION_MOVIE_ACTORS,
+    SECTION_MOVIE_YEARS,
+    SECTION_MOVIE_WEIGHTS,
+    SECTION_ACTOR_NAME_CHARS,
+    SECTION_ACTOR_NAME_OFFSETS,
+    SECTION_ACTOR_NAME_ORDER,
+    SECTION_MOVIE_TITLE_CHARS,
+    SECTION_MOVIE_TITLE_OFFSETS,
+    SECTION_MOVIE_ORDER,
+    SECTION_LANDMARKS,
+    SECTION_LANDMARK_DISTANCES,
+    SECTION_HIERARCHY_OFFSETS,
+    SECTION_HIERARCHY_TARGETS,
+    SECTION_HIERARCHY_WEIGHTS,
+    SECTION_HIERARCHY_MIDDLES,
+    SECTION_LABEL_OFFSETS,
+    SECTION_LABEL_HUBS,
+    SECTION_LABEL_DISTANCES,
+    SECTION_ACTOR_COMPONENTS,
+    SECTION_COMPONENT_SIZES
+};
+
+struct SnapshotHeader {
+    char magic[8];          // "ACTGRAPH"
+    uint32_t version;
+    uint32_t flags;
+    uint32_t numSections;
+    uint32_t reserved;
+};
+
+struct SnapshotSection {
+    uint32_t id;
+    uint32_t elementSize;   // Size of one array element in bytes
+    uint64_t offset;        // From the start of the file
+    uint64_t count;         // Number of array elements
+};
+
+class SnapshotWriter {
+    private:
+        struct PendingSection {
+            SnapshotSection info;
+            const void* data;
+        };
+
+        uint32_t flags;
+        vector<PendingSection> sections;
+
+    public:
+        /* Constructor */
+        SnapshotWriter(uint32_t flags) : flags(flags) {}
+
+        /* Add an array as a section. The array must stay alive until write(). */
+        template <typename T>
+        void addSection(uint32_t id, ArrayView<T> array) {
+            sections.push_back({{id, (uint32_t)sizeof(T), 0, array.size()}, array.data()});
+        }
+
+        /* Write the snapshot to filename.
+         * Return true if the file was written successfully, and false otherwise.
+         */
+        bool write(const char* filename);
+};
+
+class SnapshotFile {
+    private:
+        MappedFile file;
+        const SnapshotHeader* header;
+        const SnapshotSection* sections;
+
+        /* Return the section with the given ID, or nullptr if missing. */
+        const SnapshotSection* findSection(uint32_t id, uint32_t elementSize) const;
+
+    public:
+        /* Constructor */
+        SnapshotFile() : header(nullptr), sections(nullptr) {}
+
+        /* Map filename and check its header and section table.
+         * Return true if it is a valid snapshot, and false otherwise.
+         */
+        bool open(const char* filename);
+
+        /* Return the header flags of the snapshot. */
+        uint32_t flags() const { return header->flags; }
+
+        /* Point array at the section with the given ID.
+         * Return false if the section is missing or has the wrong element type.
+         */
+        template <typename T>
+        bool section(uint32_t id, ArrayView<T>& array) const {
+            const SnapshotSection* s = findSection(id, sizeof(T));
+            if(!s)
+                return false;
+            array = ArrayView<T>((const T*)(file.data() + s->offset), s->count);
+            return true;
+        }
+};
+
+#endif // GRAPHSNAPSHOT_H
@@ -0,0 +1,361 @@
+/* HubLabelIndex.cpp
+ * Pruned landmark labeling of the unweighted co-star graph of a frozen
+ * Actor Graph.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include "HubLabelIndex.h"
+#include "ActorGraph.h"
+#include "Parallel.h"
+
+using namespace std;
+
+const uint32_t HubLabelIndex::NONE;
+const uint8_t HubLabelIndex::UNSET;
+const uint8_t HubLabelIndex::MAX_DISTANCE;
+const int HubLabelIndex::UNREACHABLE;
+
+
+/* One entry of a label while the index is built */
+struct LabelEntry {
+    uint32_t hub;       // Rank of the hub
+    uint8_t distance;
+};
+
+/* State of a pruned search, reused across the hubs one thread searches */
+struct PrunedSearch {
+    vector<uint8_t> hubDistance;    // Distance from the hub to each hub rank
+    vector<uint8_t> actorDistance;  // Distance from the hub to each actor
+    vector<bool> movieDone;
+    vector<uint32_t> queue;         // Actors reached, in order of distance
+    vector<uint32_t> movies;        // Movies expanded
+
+    PrunedSearch(uint32_t num_actors, uint32_t num_movies) :
+        hubDistance(num_actors, HubLabelIndex::UNSET),
+        actorDistance(num_actors, HubLabelIndex::UNSET),
+        movieDone(num_movies, false) {}
+};
+
+/* Run a breadth first search from hub, appending every actor it labels
+ * and its distance to found. The search is pruned at actors whose labels
+ * already give a path as short.
+ * Return false if a labeled actor is farther than MAX_DISTANCE.
+ */
+static bool prunedSearch(const CSRView& csr, uint32_t hub,
+    const vector<vector<LabelEntry>>& labels, PrunedSearch& s,
+    vector<pair<uint32_t, uint8_t>>& found) {
+    bool fits = true;
+
+    // Distances from the hub to its own hubs, for checking labels against
+    for(auto& entry : labels[hub])
+        s.hubDistance[entry.hub] = entry.distance;
+
+    s.queue.clear();
+    s.queue.push_back(hub);
+    s.actorDistance[hub] = 0;
+
+    for(size_t head = 0; head < s.queue.size(); head++) {
+        uint32_t curr = s.queue[head];
+        uint8_t d = s.actorDistance[curr];
+
+        // Prune if an earlier hub already lies on a path this short
+        bool covered = false;
+        for(auto& entry : labels[curr]) {
+            if(s.hubDistance[entry.hub] != HubLabelIndex::UNSET && s.hubDistance[entry.hub] + entry.distance <= d) {
+                covered = true;
+                break;
+            }
+        }
+        if(covered)
+            continue;
+
+        found.push_back(make_pair(curr, d));
+        if(d == HubLabelIndex::MAX_DISTANCE) {
+            fits = false;
+            continue;
+        }
+
+        for(uint32_t i = csr.actorOffsets[curr]; i < csr.actorOffsets[curr + 1]; i++) {
+            uint32_t movie = csr.actorMovies[i];
+            if(s.movieDone[movie])
+                continue;
+            s.movieDone[movie] = true;
+            s.movies.push_back(movie);
+
+            for(uint32_t j = csr.movieOffsets[movie]; j < csr.movieOffsets[movie + 1]; j++) {
+                uint32_t next = csr.movieActors[j];
+                if(s.actorDistance[next] == HubLabelIndex::UNSET) {
+                    s.actorDistance[next] = d + 1;
+                    s.queue.push_back(next);
+                }
+            }
+        }
+    }
+
+    // Reset only what the search touched
+    for(uint32_t actor : s.queue)
+        s.actorDistance[actor] = HubLabelIndex::UNSET;
+    for(uint32_t movie : s.movies)
+        s.movieDone[movie] = false;
+    s.movies.clear();
+    for(auto& entry : labels[hub])
+        s.hubDistance[entry.hub] = HubLabelIndex::UNSET;
+
+    return fits;
+}
+
+/* Run a breadth first search from every actor in rank order, adding
+ * the hub to the label of each actor it reaches, and pruning the
+ * search at actors whose labels already give a path as short.
+ * With num_threads > 1, batches of hubs are searched in parallel, each
+ * pruned only by the labels of earlier batches. This adds some redundant
+ * labels, and distances stay exact.
+ * The graph must be frozen.
+ * Return true if the index was built, and false otherwise.
+ */
+bool HubLabelIndex::build(const ActorGraph& graph, unsigned num_threads) {
+    CSRView csr = graph.csrView();
+    uint32_t num_actors = graph.numActors();
+    if(!graph.isFrozen() || num_actors == 0)
+        return false;
+
+    if(num_threads < 1)
+        num_threads = 1;
+
+    // Rank actors by their number of co-star links, most first, since
+    // searches from well connected hubs prune the later ones most
+    vector<uint64_t> degree(num_actors, 0);
+    for(uint32_t v = 0; v < num_actors; v++) {
+        for(uint32_t i = csr.actorOffsets[v]; i < csr.actorOffsets[v + 1]; i++) {
+            uint32_t movie = csr.actorMovies[i];
+            degree[v] += csr.movieOffsets[movie + 1] - csr.movieOffsets[movie] - 1;
+        }
+    }
+
+    vector<uint32_t> order(num_actors);
+    for(uint32_t v = 0; v < num_actors; v++)
+        order[v] = v;
+    stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return degree[a] > degree[b];
+    });
+
+    vector<vector<LabelEntry>> labels(num_actors);
+    vector<PrunedSearch> searches(num_threads, PrunedSearch(num_actors, csr.numMovies()));
+    vector<vector<pair<uint32_t, uint8_t>>> found;
+    atomic<bool> fits(true);
+
+    // Hubs of a batch only see the labels of earlier batches. Their labels
+    // are added in rank order once the batch is done, so every label stays
+    // sorted by rank. Later hubs are pruned early, so their batches grow to
+    // keep the threads busy.
+    uint32_t first = 0;
+    while(first < num_actors && fits) {
+        uint32_t batch = num_threads > 1 ? max(num_threads, first / 16) : 1;
+        batch = min(batch, num_actors - first);
+        if(found.size() < batch)
+            found.resize(batch);
+
+        parallelForEach(min(num_threads, batch), batch, [&](unsigned t, size_t i) {
+            found[i].clear();
+            if(!prunedSearch(csr, order[first + i], labels, searches[t], found[i]))
+                fits = false;
+        });
+
+        for(uint32_t i = 0; i < batch; i++) {
+            for(auto& item : found[i])
+                labels[item.first].push_back({first + i, item.second});
+        }
+
+        first += batch;
+    }
+
+    if(!fits)
+        return false;
+
+    // Compact the labels into CSR arrays
+    ownOffsets.assign(num_actors + 1, 0);
+    for(uint32_t v = 0; v < num_actors; v++)
+        ownOffsets[v + 1] = ownOffsets[v] + labels[v].size();
+
+    ownHubs.resize(ownOffsets[num_actors]);
+    ownDistances.resize(ownOffsets[num_actors]);
+    for(uint32_t v = 0; v < num_actors; v++) {
+        for(size_t i = 0; i < labels[v].size(); i++) {
+            ownHubs[ownOffsets[v] + i] = labels[v][i].hub;
+            ownDistances[ownOffsets[v] + i] = labels[v][i].distance;
+        }
+        vector<LabelEntry>().swap(labels[v]);
+    }
+
+    labelOffsets = ownOffsets;
+    labelHubs = ownHubs;
+    labelDistances = ownDistances;
+    return true;
+}
+
+/* Use label arrays stored elsewhere, such as in a snapshot, for a
+ * graph of num_actors actors.
+ * Return true if the arrays are consistent, and false otherwise.
+ */
+bool HubLabelIndex::attach(ArrayView<uint32_t> offsets, ArrayView<uint32_t> hubs,
+    ArrayView<uint8_t> distances, uint32_t num_actors) {
+    if(offsets.size() != (size_t)num_actors + 1 || offsets[0] != 0
+        || offsets[num_actors] != hubs.size() || distances.size() != hubs.size())
+        return false;
+
+    for(uint32_t v = 0; v < num_actors; v++) {
+        if(offsets[v] > offsets[v + 1])
+            return false;
+
+        // Labels must be sorted by hub rank for queries to merge them
+        for(uint32_t i = offsets[v]; i < offsets[v + 1]; i++) {
+            if(hubs[i] >= num_actors || (i > offsets[v] && hubs[i] <= hubs[i - 1]))
+                return false;
+        }
+    }
+
+    labelOffsets = offsets;
+    labelHubs = hubs;
+    labelDistances = distances;
+    return true;
+}
+
+/* Return the number of movie hops between actors s and t, or
+ * UNREACHABLE if they aren't connected.
+ */
+int HubLabelIndex::distance(uint32_t s, uint32_t t) const {
+    uint32_t i = labelOffsets[s];
+    uint32_t j = labelOffsets[t];
+    uint32_t s_end = labelOffsets[s + 1];
+    uint32_t t_end = labelOffsets[t + 1];
+
+    // Both labels are sorted by hub, so their common hubs are found by
+    // merging them
+    int best = UNREACHABLE;
+    while(i < s_end && j < t_end) {
+        if(labelHubs[i] < labelHubs[j]) {
+            i++;
+        } else if(labelHubs[i] > labelHubs[j]) {
+            j++;
+        } else {
+            best = min(best, labelDistances[i] + labelDistances[j]);
+            i++;
+            j++;
+        }
+    }
+
+    return best;
+}
+
+/* Return the distance from actor v to the hub of rank hub, or UNSET if
+ * the hub isn't in v's label.
+ */
+uint8_t HubLabelIndex::hubDistance(uint32_t v, uint32_t hub) const {
+    const uint32_t* begin = labelHubs.data() + labelOffsets[v];
+    const uint32_t* end = labelHubs.data() + labelOffsets[v + 1];
+    const uint32_t* entry = lower_bound(begin, end, hub);
+    if(entry == end || *entry != hub)
+        return UNSET;
+    return labelDistances[entry - labelHubs.data()];
+}
+
+/* Append the actors on a shortest path from v to the hub of rank hub,
+ * excluding v, to path, and the movies between them to pathMovies.
+ * v's label must hold the hub.
+ * Return true if the walk reached the hub, and false if it got stuck
+ * at an actor with no co-star one hop closer, as a corrupt index can.
+ */
+bool HubLabelIndex::pathToHub(const CSRView& csr, uint32_t v, uint32_t hub,
+    vector<uint32_t>& path, vector<uint32_t>& pathMovies) const {
+    uint8_t d = hubDistance(v, hub);
+
+    while(d > 0) {
+        // The search from the hub reached v through a co-star it didn't
+        // prune, so some co-star holds the hub one hop closer
+        uint32_t next = NONE;
+        uint32_t next_movie = NONE;
+        for(uint32_t i = csr.actorOffsets[v]; i < csr.actorOffsets[v + 1] && next == NONE; i++) {
+            uint32_t movie = csr.actorMovies[i];
+            for(uint32_t j = csr.movieOffsets[movie]; j < csr.movieOffsets[movie + 1]; j++) {
+                uint32_t actor = csr.movieActors[j];
+                if(hubDistance(actor, hub) == d - 1) {
+                    next = actor;
+                    next_movie = movie;
+                    break;
+                }
+            }
+        }
+
+        if(next == NONE)
+            return false;
+
+        path.push_back(next);
+        pathMovies.push_back(next_movie);
+        v = next;
+        d--;
+    }
+
+    return true;
+}
+
+/* Find a shortest unweighted path from actor src to actor dst on
+ * the graph csr. The path runs through the hub their labels meet at,
+ * and each half is found by stepping to a co-star one hop closer to
+ * the hub. Fill path with its actors and pathMovies with the movies
+ * between them.
+ * Like BFS, an actor has no path to itself.
+ * Return true if a path exists, and false otherwise.
+ */
+bool HubLabelIndex::path(const CSRView& csr, uint32_t src, uint32_t dst, vector<uint32_t>& path,
+    vector<uint32_t>& pathMovies) const {
+    path.clear();
+    pathMovies.clear();
+
+    if(src == NONE || dst == NONE || src == dst)
+        return false;
+
+    // Find the common hub on a shortest path, as distance does
+    uint32_t i = labelOffsets[src];
+    uint32_t j = labelOffsets[dst];
+    int best = UNREACHABLE;
+    uint32_t hub = NONE;
+    while(i < labelOffsets[src + 1] && j < labelOffsets[dst + 1]) {
+        if(labelHubs[i] < labelHubs[j]) {
+            i++;
+        } else if(labelHubs[i] > labelHubs[j]) {
+            j++;
+        } else {
+            if(labelDistances[i] + labelDistances[j] < best) {
+                best = labelDistances[i] + labelDistances[j];
+                hub = labelHubs[i];
+            }
+            i++;
+            j++;
+        }
+    }
+
+    if(hub == NONE)
+        return false;
+
+    // Walk from src up to the hub, then from dst up to the hub, and join
+    // the second half on in reverse
+    vector<uint32_t> back, backMovies;
+    path.push_back(src);
+    if(!pathToHub(csr, src, hub, path, pathMovies)
+        || !pathToHub(csr, dst, hub, back, backMovies)) {
+        path.clear();
+        pathMovies.clear();
+        return false;
+    }
+
+    // When dst is the hub itself, the first half already ends at it
+    if(!back.empty()) {
+        back.pop_back(); // The hub, already on the path
+        path.insert(path.end(), back.rbegin(), back.rend());
+        path.push_back(dst);
+    }
+    pathMovies.insert(pathMovies.end(), backMovies.rbegin(), backMovies.rend());
+
+    return true;
+}
@@ -0,0 +1,119 @@
+/* HubLabelIndex.h
+ * Pruned landmark labeling of the unweighted co-star graph of a frozen
+ * Actor Graph. Every actor is labeled with hubs and its number of movie
+ * hops to each, so the distance between two actors is found by merging
+ * their labels instead of searching the graph.
+ */
+
+#ifndef HUBLABELINDEX_H
+#define HUBLABELINDEX_H
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include "ArrayView.h"
+#include "CSRView.h"
+
+using namespace std;
+
+class ActorGraph;
+
+class HubLabelIndex {
+    private:
+        /* Labels in CSR form. Actor v's label is labelHubs[labelOffsets[v] ..
+         * labelOffsets[v + 1]), the ranks of its hubs in increasing order,
+         * with the distance to each in labelDistances. Hub ranks order the
+         * actors by co-star count, most first. The arrays either view the
+         * own* vectors or a snapshot.
+         */
+        ArrayView<uint32_t> labelOffsets;
+        ArrayView<uint32_t> labelHubs;
+        ArrayView<uint8_t> labelDistances;
+
+        vector<uint32_t> ownOffsets;
+        vector<uint32_t> ownHubs;
+        vector<uint8_t> ownDistances;
+
+        /* Return the distance from actor v to the hub of rank hub, or
+         * UNSET if the hub isn't in v's label.
+         */
+        uint8_t hubDistance(uint32_t v, uint32_t hub) const;
+
+        /* Append the actors on a shortest path from v to the hub of rank hub,
+         * excluding v, to path, and the movies between them to pathMovies.
+         * v's label must hold the hub.
+         * Return true if the walk reached the hub, and false if it got stuck
+         * at an actor with no co-star one hop closer, as a corrupt index can.
+         */
+        bool pathToHub(const CSRView& csr, uint32_t v, uint32_t hub,
+            vector<uint32_t>& path, vector<uint32_t>& pathMovies) const;
+
+    public:
+        /* Marks a missing actor */
+        static const uint32_t NONE = 0xFFFFFFFF;
+
+        /* Marks a hub missing from a label */
+        static const uint8_t UNSET = 0xFF;
+
+        /* Longest distance a label can hold. Building fails on graphs with
+         * longer shortest paths.
+         */
+        static const uint8_t MAX_DISTANCE = 254;
+
+        /* Distance between actors that aren't connected */
+        static const int UNREACHABLE = numeric_limits<int>::max();
+
+        /* Constructor */
+        HubLabelIndex() {}
+
+        /* The views point into the index itself, so it can't be copied */
+        HubLabelIndex(const HubLabelIndex&) = delete;
+        HubLabelIndex& operator=(const HubLabelIndex&) = delete;
+
+        /* Run a breadth first search from every actor in rank order, adding
+         * the hub to the label of each actor it reaches, and pruning the
+         * search at actors whose labels already give a path as short.
+         * With num_threads > 1, batches of hubs are searched in parallel, each
+         * pruned only by the labels of earlier batches. This adds some redundant
+         * labels, and distances stay exact.
+         * The graph must be frozen.
+         * Return true if the index was built, and false otherwise.
+         */
+        bool build(const ActorGraph& graph, unsigned num_threads = 1);
+
+        /* Use label arrays stored elsewhere, such as in a snapshot, for a
+         * graph of num_actors actors.
+         * Return true if the arrays are consistent, and false otherwise.
+         */
+        bool attach(ArrayView<uint32_t> offsets, ArrayView<uint32_t> hubs,
+            ArrayView<uint8_t> distances, uint32_t num_actors);
+
+        /* Return true if the index has been built or attached. */
+        bool isBuilt() const { return !labelOffsets.empty(); }
+
+        /* Return the total number of label entries. */
+        size_t size() const { return labelHubs.size(); }
+
+        /* Return the label arrays, for saving. */
+        ArrayView<uint32_t> offsetArray() const { return labelOffsets; }
+        ArrayView<uint32_t> hubArray() const { return labelHubs; }
+        ArrayView<uint8_t> distanceArray() const { return labelDistances; }
+
+        /* Return the number of movie hops between actors s and t, or
+         * UNREACHABLE if they aren't connected.
+         */
+        int distance(uint32_t s, uint32_t t) const;
+
+        /* Find a shortest unweighted path from actor src to actor dst on
+         * the graph csr. The path runs through the hub their labels meet at,
+         * and each half is found by stepping to a co-star one hop closer to
+         * the hub. Fill path with its actors and pathMovies with the movies
+         * between them.
+         * Like BFS, an actor has no path to itself.
+         * Return true if a path exists, and false otherwise.
+         */
+        bool path(const CSRView& csr, uint32_t src, uint32_t dst, vector<uint32_t>& path,
+            vector<uint32_t>& pathMovies) const;
+};
+
+#endif // HUBLABELINDEX_H
@@ -0,0 +1,174 @@
+/* LandmarkIndex.cpp
+ * Distances from a few landmark actors to every actor of a frozen Actor
+ * Graph, giving lower bounds on weighted path costs for A* search (ALT).
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include "LandmarkIndex.h"
+#include "ActorGraph.h"
+#include "SearchWorkspace.h"
+
+using namespace std;
+
+const unsigned LandmarkIndex::MAX_LANDMARKS;
+const int LandmarkIndex::UNREACHABLE;
+
+/* Spread up to num_landmarks landmarks over the connected components
+ * in proportion to their size, and compute their distances to every
+ * actor with Dijkstra's algorithm. A component's first landmark is its
+ * actor with the most movies, and the rest are picked by farthest-point
+ * selection. Components of a single actor get none.
+ * The graph must be frozen and have no negative weights.
+ * Return true if the index was built, and false otherwise.
+ */
+bool LandmarkIndex::build(const ActorGraph& graph, unsigned num_landmarks) {
+    CSRView csr = graph.csrView();
+    uint32_t num_actors = graph.numActors();
+    if(!graph.isFrozen() || num_actors == 0)
+        return false;
+
+    for(int weight : csr.movieWeight) {
+        if(weight < 0)
+            return false;
+    }
+
+    num_landmarks = min(num_landmarks, MAX_LANDMARKS);
+    num_landmarks = min(num_landmarks, num_actors);
+
+    // Distance of each actor to its nearest landmark so far. Landmarks
+    // only reach their own component, so within a component this is the
+    // distance to its nearest landmark.
+    vector<int> nearest(num_actors, UNREACHABLE);
+    vector<vector<int>> columns;
+    vector<uint32_t> chosen;
+    SearchWorkspace ws(graph);
+
+    // Landmarks in each component, and whether every actor of it is at
+    // distance 0 from one already
+    ArrayView<uint32_t> component_size = graph.componentSizes();
+    vector<uint32_t> component_landmarks(component_size.size(), 0);
+    vector<bool> exhausted(component_size.size(), false);
+
+    while(chosen.size() < num_landmarks) {
+        // Give the landmark to the component that would have the most
+        // actors per landmark with it
+        uint32_t c = ActorGraph::NONE;
+        for(uint32_t i = 0; i < component_size.size(); i++) {
+            if(component_size[i] < 2 || exhausted[i])
+                continue;
+            if(c == ActorGraph::NONE || (uint64_t)component_size[i] * (component_landmarks[c] + 1)
+                > (uint64_t)component_size[c] * (component_landmarks[i] + 1))
+                c = i;
+        }
+
+        // Every component has all the landmarks it can use
+        if(c == ActorGraph::NONE)
+            break;
+
+        uint32_t next = ActorGraph::NONE;
+        if(component_landmarks[c] == 0) {
+            // Start at the component's actor with the most movies
+            uint32_t most = 0;
+            for(uint32_t v = 0; v < num_actors; v++) {
+                if(graph.componentOf(v) != c)
+                    continue;
+                uint32_t degree = csr.actorOffsets[v + 1] - csr.actorOffsets[v];
+                if(next == ActorGraph::NONE || degree > most) {
+                    next = v;
+                    most = degree;
+                }
+            }
+        } else {
+            // Then its actor farthest from every landmark so far
+            int farthest = 0;
+            for(uint32_t v = 0; v < num_actors; v++) {
+                if(graph.componentOf(v) == c && nearest[v] > farthest) {
+                    next = v;
+                    farthest = nearest[v];
+                }
+            }
+        }
+
+        if(next == ActorGraph::NONE) {
+            exhausted[c] = true;
+            continue;
+        }
+
+        graph.Dijkstras(ws, next, vector<uint32_t>());
+        chosen.push_back(next);
+        component_landmarks[c]++;
+        columns.push_back(vector<int>(num_actors));
+
+        // Actors the search didn't reach were never touched
+        for(uint32_t v = 0; v < num_actors; v++) {
+            columns.back()[v] = ws.distanceTo(v);
+            nearest[v] = min(nearest[v], columns.back()[v]);
+        }
+    }
+
+    // Store the distances of each actor next to each other
+    uint32_t k = chosen.size();
+    ownLandmarks = chosen;
+    ownDistances.resize((size_t)num_actors * k);
+    for(uint32_t v = 0; v < num_actors; v++) {
+        for(uint32_t i = 0; i < k; i++)
+            ownDistances[(size_t)v * k + i] = columns[i][v];
+    }
+
+    landmarks = ownLandmarks;
+    distances = ownDistances;
+    return true;
+}
+
+/* Use landmark and distance arrays stored elsewhere, such as in
+ * a snapshot, for a graph of num_actors actors.
+ * Return true if the arrays are consistent, and false otherwise.
+ */
+bool LandmarkIndex::attach(ArrayView<uint32_t> landmark_ids, ArrayView<int> landmark_distances,
+    uint32_t num_actors) {
+    if(landmark_ids.size() > MAX_LANDMARKS
+        || landmark_distances.size() != (size_t)num_actors * landmark_ids.size())
+        return false;
+
+    for(uint32_t id : landmark_ids) {
+        if(id >= num_actors)
+            return false;
+    }
+
+    landmarks = landmark_ids;
+    distances = landmark_distances;
+    return true;
+}
+
+/* Return a lower bound on the cost of a path from v to t. */
+int LandmarkIndex::lowerBound(uint32_t v, uint32_t t) const {
+    uint32_t k = landmarks.size();
+    const int* dv = distances.data() + (size_t)v * k;
+    const int* dt = distances.data() + (size_t)t * k;
+
+    // By the triangle inequality, d(v, t) >= |d(L, t) - d(L, v)|
+    int bound = 0;
+    for(uint32_t i = 0; i < k; i++) {
+        if(dv[i] != UNREACHABLE && dt[i] != UNREACHABLE)
+            bound = max(bound, abs(dt[i] - dv[i]));
+    }
+
+    return bound;
+}
+
+/* Return true if some landmark reaches exactly one of v and t, which
+ * proves there is no path between them.
+ */
+bool LandmarkIndex::separated(uint32_t v, uint32_t t) const {
+    uint32_t k = landmarks.size();
+    const int* dv = distances.data() + (size_t)v * k;
+    const int* dt = distances.data() + (size_t)t * k;
+
+    for(uint32_t i = 0; i < k; i++) {
+        if((dv[i] == UNREACHABLE) != (dt[i] == UNREACHABLE))
+            return true;
+    }
+
+    return false;
+}
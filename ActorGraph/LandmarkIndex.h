@@ -0,0 +1,79 @@
+/* LandmarkIndex.h
+ * Distances from a few landmark actors to every actor of a frozen Actor
+ * Graph, giving lower bounds on weighted path costs for A* search (ALT).
+ */
+
+#ifndef LANDMARKINDEX_H
+#define LANDMARKINDEX_H
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include "ArrayView.h"
+
+using namespace std;
+
+class ActorGraph;
+
+class LandmarkIndex {
+    private:
+        /* Landmark actor IDs, and the weighted distance from landmark k to
+         * actor v at distances[v * size() + k], UNREACHABLE if not connected.
+         * Both either view ownLandmarks and ownDistances or a snapshot.
+         */
+        ArrayView<uint32_t> landmarks;
+        ArrayView<int> distances;
+
+        vector<uint32_t> ownLandmarks;
+        vector<int> ownDistances;
+
+    public:
+        /* Most landmarks an index holds, bounding it to
+         * 4 * MAX_LANDMARKS bytes per actor
+         */
+        static const unsigned MAX_LANDMARKS = 64;
+
+        /* Distance to an actor not connected to the landmark */
+        static const int UNREACHABLE = numeric_limits<int>::max();
+
+        /* Constructor */
+        LandmarkIndex() {}
+
+        /* The views point into the index itself, so it can't be copied */
+        LandmarkIndex(const LandmarkIndex&) = delete;
+        LandmarkIndex& operator=(const LandmarkIndex&) = delete;
+
+        /* Spread up to num_landmarks landmarks over the connected components
+         * in proportion to their size, and compute their distances to every
+         * actor with Dijkstra's algorithm. A component's first landmark is its
+         * actor with the most movies, and the rest are picked by farthest-point
+         * selection. Components of a single actor get none.
+         * The graph must be frozen and have no negative weights.
+         * Return true if the index was built, and false otherwise.
+         */
+        bool build(const ActorGraph& graph, unsigned num_landmarks);
+
+        /* Use landmark and distance arrays stored elsewhere, such as in
+         * a snapshot, for a graph of num_actors actors.
+         * Return true if the arrays are consistent, and false otherwise.
+         */
+        bool attach(ArrayView<uint32_t> landmark_ids, ArrayView<int> landmark_distances,
+            uint32_t num_actors);
+
+        /* Return the number of landmarks. */
+        uint32_t size() const { return landmarks.size(); }
+
+        /* Return the landmark actor IDs and the distance array, for saving. */
+        ArrayView<uint32_t> landmarkArray() const { return landmarks; }
+        ArrayView<int> distanceArray() const { return distances; }
+
+        /* Return a lower bound on the cost of a path from v to t. */
+        int lowerBound(uint32_t v, uint32_t t) const;
+
+        /* Return true if some landmark reaches exactly one of v and t, which
+         * proves there is no path between them.
+         */
+        bool separated(uint32_t v, uint32_t t) const;
+};
+
+#endif // LANDMARKINDEX_H
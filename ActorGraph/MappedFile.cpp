@@ -0,0 +1,55 @@
+/* MappedFile.cpp
+ * Read-only memory mapping of a whole file.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "MappedFile.h"
+
+/* Map filename read-only into memory. Pass sequential = true if the
+ * file will be read front to back once.
+ * Return true if file was mapped successfully, and false otherwise.
+ */
+bool MappedFile::open(const char* filename, bool sequential) {
+    close();
+
+    int fd = ::open(filename, O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat st;
+    if(fstat(fd, &st) < 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // An empty file can't be mapped, but it is still a valid file
+    if(st.st_size > 0) {
+        void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if(addr == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+
+        if(sequential)
+            madvise(addr, st.st_size, MADV_SEQUENTIAL);
+
+        ptr = (const char*)addr;
+        length = st.st_size;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+    return true;
+}
+
+/* Unmap the file. Pointers into the mapping become invalid. */
+void MappedFile::close() {
+    if(ptr)
+        munmap((void*)ptr, length);
+
+    ptr = nullptr;
+    length = 0;
+}
@@ -0,0 +1,42 @@
+/* MappedFile.h
+ * Read-only memory mapping of a whole file.
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+
+class MappedFile {
+    private:
+        const char* ptr;    // Start of the mapping
+        size_t length;      // Size of the mapping in bytes
+
+    public:
+        /* Constructor */
+        MappedFile() : ptr(nullptr), length(0) {}
+
+        /* A mapping is owned by one object, so it can't be copied */
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /* Map filename read-only into memory. Pass sequential = true if the
+         * file will be read front to back once.
+         * Return true if file was mapped successfully, and false otherwise.
+         */
+        bool open(const char* filename, bool sequential = false);
+
+        /* Unmap the file. Pointers into the mapping become invalid. */
+        void close();
+
+        /* Return the first byte of the file. */
+        const char* data() const { return ptr; }
+
+        /* Return the size of the file in bytes. */
+        size_t size() const { return length; }
+
+        /* Destructor */
+        ~MappedFile() { close(); }
+};
+
+#endif // MAPPEDFILE_H
@@ -7,12 +7,13 @@
 #define MOVIEACTORLIST_H
 
 #include <vector>
+#include <cstdint>
 
 struct MovieActorList {
-    std::string movie;
+    uint32_t movie; // Movie ID
     int year;
-    mutable std::vector<string> actorList;
+    std::vector<uint32_t> actorList; // Actor IDs in cast file order
 
-    MovieActorList(std::string movie, int year) : movie(movie), year(year) {}
+    MovieActorList(uint32_t movie, int year) : movie(movie), year(year) {}
 };
 #endif // MOVIEACTORLIST_H
@@ -0,0 +1,266 @@
+/* MultiSourceBFS.cpp
+ * Bit-parallel Breadth First Search from up to 64 sources at once on the
+ * CSR arrays of a frozen Actor Graph.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include "MultiSourceBFS.h"
+#include "Parallel.h"
+
+using namespace std;
+
+const unsigned MultiSourceBFS::BATCH_SIZE;
+const int MultiSourceBFS::MAX_DEPTH;
+
+/* Constructor, allocating search state for every actor and movie:
+ * about 28 bytes per actor and 16 per movie, plus 16 bytes for each
+ * level at which a search first reaches an actor
+ */
+MultiSourceBFS::MultiSourceBFS(const ActorGraph& graph) :
+    graph(graph.csrView()),
+    seen(graph.numActors(), 0),
+    frontier(graph.numActors(), 0),
+    next(graph.numActors(), 0),
+    movieSeen(graph.numMovies(), 0),
+    movieNext(graph.numMovies(), 0),
+    lastEntry(graph.numActors(), ActorGraph::NONE),
+    truncated(false) {}
+
+/* Mark actor as reached by the sources in bits at level. */
+void MultiSourceBFS::reach(uint32_t actor, uint64_t bits, int level) {
+    if(!seen[actor])
+        reachedActors.push_back(actor);
+    seen[actor] |= bits;
+
+    // Levels only grow, so the latest entry is the only one to add to
+    uint32_t last = lastEntry[actor];
+    if(last != ActorGraph::NONE && entries[last].level == level) {
+        entries[last].bits |= bits;
+    } else {
+        entries.push_back(LevelEntry{bits, last, (uint16_t)level});
+        lastEntry[actor] = entries.size() - 1;
+    }
+}
+
+/* Return the distance of actor from the k-th source, or -1 if the
+ * source didn't reach it.
+ */
+int MultiSourceBFS::depthOf(uint32_t actor, unsigned k) const {
+    for(uint32_t e = lastEntry[actor]; e != ActorGraph::NONE; e = entries[e].previous) {
+        if(entries[e].bits >> k & 1)
+            return entries[e].level;
+    }
+    return -1;
+}
+
+/* Run BFS from each of sources at once, until every pair
+ * (sources[pairSource[i]], pairDst[i]) is connected or no more
+ * actors can be reached. There are at most BATCH_SIZE sources.
+ */
+void MultiSourceBFS::search(const vector<uint32_t>& sources, const vector<unsigned>& pairSource,
+    const vector<uint32_t>& pairDst) {
+    // Clear only what the last search reached
+    for(uint32_t actor : reachedActors) {
+        seen[actor] = 0;
+        lastEntry[actor] = ActorGraph::NONE;
+    }
+    for(uint32_t movie : reachedMovies)
+        movieSeen[movie] = 0;
+    reachedActors.clear();
+    reachedMovies.clear();
+    entries.clear();
+    truncated = false;
+
+    for(unsigned k = 0; k < sources.size() && k < BATCH_SIZE; k++) {
+        uint32_t src = sources[k];
+        if(!frontier[src])
+            frontierList.push_back(src);
+        frontier[src] |= uint64_t(1) << k;
+        reach(src, uint64_t(1) << k, 0);
+    }
+
+    vector<bool> settled(pairDst.size(), false);
+    size_t remaining = pairDst.size();
+
+    for(int level = 0; !frontierList.empty() && remaining > 0; level++) {
+        if(level == MAX_DEPTH) {
+            truncated = true;
+            break;
+        }
+
+        // Gather the sources reaching each movie of the frontier actors
+        for(uint32_t curr : frontierList) {
+            for(uint32_t i = graph.actorOffsets[curr]; i < graph.actorOffsets[curr + 1]; i++) {
+                uint32_t movie = graph.actorMovies[i];
+                if(!movieNext[movie])
+                    movieList.push_back(movie);
+                movieNext[movie] |= frontier[curr];
+            }
+        }
+
+        // Pass them on to the cast, each movie once per source
+        for(uint32_t movie : movieList) {
+            uint64_t mask = movieNext[movie] & ~movieSeen[movie];
+            movieNext[movie] = 0;
+            if(!mask)
+                continue;
+            if(!movieSeen[movie])
+                reachedMovies.push_back(movie);
+            movieSeen[movie] |= mask;
+
+            for(uint32_t j = graph.movieOffsets[movie]; j < graph.movieOffsets[movie + 1]; j++) {
+                uint32_t actor = graph.movieActors[j];
+                uint64_t bits = mask & ~seen[actor];
+                if(!bits)
+                    continue;
+
+                reach(actor, bits, level + 1);
+                if(!next[actor])
+                    nextList.push_back(actor);
+                next[actor] |= bits;
+            }
+        }
+        movieList.clear();
+
+        for(uint32_t curr : frontierList)
+            frontier[curr] = 0;
+        frontier.swap(next);
+        frontierList.swap(nextList);
+        nextList.clear();
+
+        // Stop once every destination has been reached from its source
+        for(size_t i = 0; i < pairDst.size(); i++) {
+            if(!settled[i] && (seen[pairDst[i]] >> pairSource[i] & 1)) {
+                settled[i] = true;
+                remaining--;
+            }
+        }
+    }
+
+    // Leave the frontier masks cleared for the next search
+    for(uint32_t curr : frontierList)
+        frontier[curr] = 0;
+    frontierList.clear();
+}
+
+/* Find a shortest path from the k-th source of the last search to dst.
+ * Fill path with its actors and pathMovies with the movies between them.
+ * Return true if dst was reached from that source, and false otherwise.
+ */
+bool MultiSourceBFS::path(unsigned k, uint32_t dst, vector<uint32_t>& path,
+    vector<uint32_t>& pathMovies) const {
+    path.clear();
+    pathMovies.clear();
+    if(!(seen[dst] >> k & 1))
+        return false;
+
+    // Walk back from dst, each step to an actor one level closer to the source
+    uint32_t curr = dst;
+    int d = depthOf(dst, k);
+    path.push_back(dst);
+
+    while(d > 0) {
+        bool found = false;
+        for(uint32_t i = graph.actorOffsets[curr]; i < graph.actorOffsets[curr + 1] && !found; i++) {
+            uint32_t movie = graph.actorMovies[i];
+
+            for(uint32_t j = graph.movieOffsets[movie]; j < graph.movieOffsets[movie + 1]; j++) {
+                uint32_t actor = graph.movieActors[j];
+                if((seen[actor] >> k & 1) && depthOf(actor, k) == d - 1) {
+                    path.push_back(actor);
+                    pathMovies.push_back(movie);
+                    curr = actor;
+                    found = true;
+                    break;
+                }
+            }
+        }
+
+        if(!found)
+            return false;
+        d--;
+    }
+
+    reverse(path.begin(), path.end());
+    reverse(pathMovies.begin(), pathMovies.end());
+    return true;
+}
+
+/* Answer each (src[i], dst[i]) pair like ActorGraph::actorPath
+ * without weights, searching up to BATCH_SIZE distinct sources
+ * per traversal. Batches run on num_threads threads, each with its
+ * own search state.
+ * Return the path strings in input order.
+ */
+vector<string> MultiSourceBFS::actorPaths(const ActorGraph& graph, const vector<string>& src,
+    const vector<string>& dst, unsigned num_threads) {
+    struct Batch {
+        vector<uint32_t> sources;
+        vector<unsigned> pairSource;
+        vector<uint32_t> pairDst;
+        vector<size_t> pairIndex;
+    };
+
+    vector<string> paths(src.size());
+    if(!graph.isFrozen())
+        return paths;
+    if(num_threads < 1)
+        num_threads = 1;
+
+    // Group pairs into batches of BATCH_SIZE distinct sources, in order of
+    // first appearance. Pairs sharing a source share its bit.
+    vector<Batch> batches;
+    unordered_map<uint32_t, pair<size_t, unsigned>> sourceBit;
+    for(size_t i = 0; i < src.size(); i++) {
+        uint32_t srcId = graph.findNode(src[i]);
+        uint32_t dstId = graph.findNode(dst[i]);
+
+        // Like BFS, an actor has no path to itself, and actors in
+        // different components have none either
+        if(srcId == ActorGraph::NONE || dstId == ActorGraph::NONE || srcId == dstId
+            || graph.componentOf(srcId) != graph.componentOf(dstId)) {
+            paths[i] = "Path from " + src[i] + " to " + dst[i] + " doesn't exist.";
+            continue;
+        }
+
+        auto it = sourceBit.find(srcId);
+        if(it == sourceBit.end()) {
+            if(batches.empty() || batches.back().sources.size() == BATCH_SIZE)
+                batches.emplace_back();
+            batches.back().sources.push_back(srcId);
+            it = sourceBit.emplace(srcId, make_pair(batches.size() - 1,
+                (unsigned)batches.back().sources.size() - 1)).first;
+        }
+
+        Batch& batch = batches[it->second.first];
+        batch.pairSource.push_back(it->second.second);
+        batch.pairDst.push_back(dstId);
+        batch.pairIndex.push_back(i);
+    }
+
+    // Each thread searches whole batches with its own search state
+    vector<unique_ptr<MultiSourceBFS>> engines(num_threads);
+    parallelForEach(num_threads, batches.size(), [&](unsigned t, size_t b) {
+        if(!engines[t])
+            engines[t].reset(new MultiSourceBFS(graph));
+        MultiSourceBFS& engine = *engines[t];
+
+        Batch& batch = batches[b];
+        engine.search(batch.sources, batch.pairSource, batch.pairDst);
+
+        vector<uint32_t> path, pathMovies;
+        for(size_t j = 0; j < batch.pairIndex.size(); j++) {
+            size_t i = batch.pairIndex[j];
+            if(engine.path(batch.pairSource[j], batch.pairDst[j], path, pathMovies))
+                paths[i] = graph.formatPath(path, pathMovies);
+            else if(engine.isTruncated())
+                paths[i] = graph.actorPath(src[i], dst[i], false);
+            else
+                paths[i] = "Path from " + src[i] + " to " + dst[i] + " doesn't exist.";
+        }
+    });
+
+    return paths;
+}
@@ -0,0 +1,118 @@
+/* MultiSourceBFS.h
+ * Bit-parallel Breadth First Search from up to 64 sources at once on the
+ * CSR arrays of a frozen Actor Graph, sharing one traversal between many
+ * unweighted path queries.
+ */
+
+#ifndef MULTISOURCEBFS_H
+#define MULTISOURCEBFS_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "ActorGraph.h"
+#include "CSRView.h"
+
+using namespace std;
+
+class MultiSourceBFS {
+    private:
+        CSRView graph;
+
+        /* Bit k of an actor's masks stands for the k-th source of the batch.
+         * seen has the sources that reached the actor, and frontier and next
+         * those that reached it in the current and in the next level.
+         */
+        vector<uint64_t> seen;
+        vector<uint64_t> frontier;
+        vector<uint64_t> next;
+
+        /* Sources that reached each movie, and those reaching it in the
+         * current level
+         */
+        vector<uint64_t> movieSeen;
+        vector<uint64_t> movieNext;
+
+        /* Actors in the frontier and next masks, and movies in movieNext */
+        vector<uint32_t> frontierList;
+        vector<uint32_t> nextList;
+        vector<uint32_t> movieList;
+
+        /* Actors and movies some source reached, so the next search only
+         * clears those
+         */
+        vector<uint32_t> reachedActors;
+        vector<uint32_t> reachedMovies;
+
+        /* Sources that first reached an actor at one level, and the index of
+         * the actor's entry for an earlier level, or NONE
+         */
+        struct LevelEntry {
+            uint64_t bits;
+            uint32_t previous;
+            uint16_t level;
+        };
+
+        /* Entries of every reached actor, and the index of each actor's
+         * latest entry, NONE if it wasn't reached. The distance of actor a
+         * from source k is the level of a's entry with bit k set.
+         */
+        vector<LevelEntry> entries;
+        vector<uint32_t> lastEntry;
+
+        /* True if the last search stopped at MAX_DEPTH before reaching
+         * every destination
+         */
+        bool truncated;
+
+        /* Mark actor as reached by the sources in bits at level. */
+        void reach(uint32_t actor, uint64_t bits, int level);
+
+        /* Return the distance of actor from the k-th source, or -1 if the
+         * source didn't reach it.
+         */
+        int depthOf(uint32_t actor, unsigned k) const;
+
+    public:
+        /* Number of sources searched at once, one per bit of a mask */
+        static const unsigned BATCH_SIZE = 64;
+
+        /* Deepest level recorded, the limit of a depth entry */
+        static const int MAX_DEPTH = 0xFFFF;
+
+        /* Constructor, allocating search state for every actor and movie:
+         * about 28 bytes per actor and 16 per movie, plus 16 bytes for each
+         * level at which a search first reaches an actor
+         */
+        MultiSourceBFS(const ActorGraph& graph);
+
+        /* Run BFS from each of sources at once, until every pair
+         * (sources[pairSource[i]], pairDst[i]) is connected or no more
+         * actors can be reached. There are at most BATCH_SIZE sources.
+         */
+        void search(const vector<uint32_t>& sources, const vector<unsigned>& pairSource,
+            const vector<uint32_t>& pairDst);
+
+        /* Find a shortest path from the k-th source of the last search to dst.
+         * Fill path with its actors and pathMovies with the movies between them.
+         * Return true if dst was reached from that source, and false otherwise.
+         */
+        bool path(unsigned k, uint32_t dst, vector<uint32_t>& path,
+            vector<uint32_t>& pathMovies) const;
+
+        /* Return true if the last search stopped at MAX_DEPTH, in which
+         * case a destination not reached may still be connected.
+         */
+        bool isTruncated() const { return truncated; }
+
+        /* Answer each (src[i], dst[i]) pair like ActorGraph::actorPath
+         * without weights, searching up to BATCH_SIZE distinct sources
+         * per traversal. Batches run on num_threads threads, each with its
+         * own search state.
+         * Return the path strings in input order.
+         */
+        static vector<string> actorPaths(const ActorGraph& graph, const vector<string>& src,
+            const vector<string>& dst, unsigned num_threads = 1);
+};
+
+#endif // MULTISOURCEBFS_H
@@ -0,0 +1,63 @@
+/* Parallel.h
+ * Helpers for splitting work across threads.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+/* Call fn(thread_index) on num_threads threads and return once all are done.
+ * With a single thread, fn runs on the calling thread.
+ */
+template <typename Function>
+void runThreads(unsigned num_threads, Function fn) {
+    if(num_threads <= 1) {
+        fn(0u);
+        return;
+    }
+
+    vector<thread> threads;
+    for(unsigned t = 0; t < num_threads; t++)
+        threads.emplace_back(fn, t);
+
+    for(auto& th : threads)
+        th.join();
+}
+
+/* Split [0, n) into num_threads contiguous ranges and call
+ * fn(thread_index, begin, end) for each range on its own thread.
+ * Range t always covers the same indices for the same n and num_threads,
+ * so results can be merged deterministically in thread order.
+ * Returns once every range is done.
+ */
+template <typename Function>
+void parallelRanges(unsigned num_threads, size_t n, Function fn) {
+    if(num_threads < 1)
+        num_threads = 1;
+
+    runThreads(num_threads, [&](unsigned t) {
+        fn(t, n * t / num_threads, n * (t + 1) / num_threads);
+    });
+}
+
+/* Call fn(thread_index, i) for every i in [0, n) on a pool of num_threads
+ * threads. Threads take the next index from a shared counter, so uneven
+ * work is balanced across the pool. Returns once every index is done.
+ */
+template <typename Function>
+void parallelForEach(unsigned num_threads, size_t n, Function fn) {
+    atomic<size_t> next(0);
+
+    runThreads(num_threads, [&](unsigned t) {
+        for(size_t i = next++; i < n; i = next++)
+            fn(t, i);
+    });
+}
+
+#endif // PARALLEL_H
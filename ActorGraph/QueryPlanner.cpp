@@ -0,0 +1,87 @@
+/* QueryPlanner.cpp
+ * Plans a list of path queries on a frozen Actor Graph, grouping pairs
+ * by source so one search answers every destination of a source.
+ */
+
+#include <algorithm>
+#include <unordered_map>
+#include "QueryPlanner.h"
+#include "SearchWorkspace.h"
+#include "Parallel.h"
+
+using namespace std;
+
+/* Answer each (src[i], dst[i]) pair like ActorGraph::actorPath, with
+ * one BFS or Dijkstra per distinct source that stops once all of its
+ * destinations are found. Groups run on num_threads threads.
+ * Return the path strings in input order.
+ */
+vector<string> QueryPlanner::actorPaths(const vector<string>& src, const vector<string>& dst,
+    bool use_weighted_path, unsigned num_threads) {
+    vector<string> paths(src.size());
+    vector<uint32_t> dstIds(src.size());
+    numSearches = 0;
+    numSaved = 0;
+    if(num_threads < 1)
+        num_threads = 1;
+
+    // Group pairs by source, in order of first appearance
+    vector<SourceGroup> groups;
+    unordered_map<uint32_t, size_t> groupOf;
+    size_t num_searched_pairs = 0;
+    for(size_t i = 0; i < src.size(); i++) {
+        uint32_t srcId = graph.findNode(src[i]);
+        dstIds[i] = graph.findNode(dst[i]);
+
+        // Pairs with a missing actor or in different components need no
+        // search. Like BFS, an actor has no path to itself, while
+        // Dijkstras gives the actor alone.
+        if(srcId == ActorGraph::NONE || dstIds[i] == ActorGraph::NONE
+            || graph.componentOf(srcId) != graph.componentOf(dstIds[i])
+            || (srcId == dstIds[i] && !use_weighted_path)) {
+            paths[i] = "Path from " + src[i] + " to " + dst[i] + " doesn't exist.";
+            continue;
+        }
+
+        auto it = groupOf.find(srcId);
+        if(it == groupOf.end()) {
+            it = groupOf.emplace(srcId, groups.size()).first;
+            groups.push_back(SourceGroup());
+            groups.back().src = srcId;
+        }
+
+        SourceGroup& group = groups[it->second];
+        group.targets.push_back(dstIds[i]);
+        group.pairIndex.push_back(i);
+        num_searched_pairs++;
+    }
+
+    for(auto& group : groups) {
+        sort(group.targets.begin(), group.targets.end());
+        group.targets.erase(unique(group.targets.begin(), group.targets.end()),
+            group.targets.end());
+    }
+
+    numSearches = groups.size();
+    numSaved = num_searched_pairs - groups.size();
+
+    // One search per group, each thread with its own search workspace
+    vector<SearchWorkspace> workspaces(num_threads, SearchWorkspace(graph));
+    parallelForEach(num_threads, groups.size(), [&](unsigned t, size_t g) {
+        SearchWorkspace& ws = workspaces[t];
+        SourceGroup& group = groups[g];
+
+        if(use_weighted_path)
+            graph.Dijkstras(ws, group.src, group.targets);
+        else
+            graph.BFS(ws, group.src, group.targets);
+
+        for(size_t i : group.pairIndex) {
+            // Every destination left is in its source's component, so
+            // the search reached it
+            paths[i] = graph.formatPath(ws, dstIds[i]);
+        }
+    });
+
+    return paths;
+}
@@ -0,0 +1,52 @@
+/* QueryPlanner.h
+ * Plans a list of path queries on a frozen Actor Graph, grouping pairs
+ * by source so one search answers every destination of a source.
+ */
+
+#ifndef QUERYPLANNER_H
+#define QUERYPLANNER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "ActorGraph.h"
+
+using namespace std;
+
+class QueryPlanner {
+    private:
+        /* Pairs sharing a source, searched together */
+        struct SourceGroup {
+            uint32_t src;
+            vector<uint32_t> targets;   // Sorted distinct destinations
+            vector<size_t> pairIndex;   // Input index of each pair in the group
+        };
+
+        const ActorGraph& graph;
+
+        size_t numSearches;
+        size_t numSaved;
+
+    public:
+        /* Constructor */
+        QueryPlanner(const ActorGraph& graph) : graph(graph), numSearches(0), numSaved(0) {}
+
+        /* Answer each (src[i], dst[i]) pair like ActorGraph::actorPath, with
+         * one BFS or Dijkstra per distinct source that stops once all of its
+         * destinations are found. Groups run on num_threads threads.
+         * Return the path strings in input order.
+         */
+        vector<string> actorPaths(const vector<string>& src, const vector<string>& dst,
+            bool use_weighted_path, unsigned num_threads = 1);
+
+        /* Return the number of searches run by the last actorPaths. */
+        size_t searches() const { return numSearches; }
+
+        /* Return the number of searches the last actorPaths saved over
+         * searching once per pair.
+         */
+        size_t searchesSaved() const { return numSaved; }
+};
+
+#endif // QUERYPLANNER_H
@@ -0,0 +1,285 @@
+/* QueryServer.cpp
+ * Long-running server answering path and connection queries on a graph
+ * that is loaded once.
+ */
+
+#include <algorithm>
+#include <thread>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "QueryServer.h"
+#include "Parallel.h"
+#include "util.h"
+
+using namespace std;
+
+/* Set by requestShutdown, possibly from a signal handler */
+static volatile sig_atomic_t shutdownRequested = 0;
+
+/* Write all of data to fd.
+ * Return true if it was written, and false otherwise.
+ */
+static bool writeAll(int fd, const string& data) {
+    size_t written = 0;
+    while(written < data.size()) {
+        ssize_t n = write(fd, data.data() + written, data.size() - written);
+        if(n < 0) {
+            if(errno == EINTR)
+                continue;
+            return false;
+        }
+        written += n;
+    }
+    return true;
+}
+
+/* Prepare to serve queries on a frozen graph with num_threads query
+ * threads. The graph must outlive the server.
+ */
+QueryServer::QueryServer(const ActorGraph& graph, unsigned num_threads) :
+    graph(graph), numThreads(max(num_threads, 1u)),
+    workspaces(numThreads, SearchWorkspace(graph)) {
+    for(auto& ws : workspaces)
+        freeWorkspaces.push_back(&ws);
+
+    vector<MovieActorList>* movie_list = graph.movieList();
+    connections.build(*movie_list, graph.numActors());
+    delete movie_list;
+}
+
+/* Return the response to a path or connect request, using ws for
+ * searches.
+ */
+string QueryServer::answer(SearchWorkspace& ws, const string& request) const {
+    vector<string> fields;
+    size_t start = 0;
+    while(true) {
+        size_t tab = request.find('\t', start);
+        fields.push_back(request.substr(start, tab - start));
+        if(tab == string::npos)
+            break;
+        start = tab + 1;
+    }
+
+    if(fields.size() != 3)
+        return "error: expected a request and two tab-separated actors";
+
+    if(fields[0] == "path u" || fields[0] == "path w") {
+        bool use_weighted_path = (fields[0] == "path w");
+        if(use_weighted_path && !graph.isWeighted())
+            return "error: the graph has no edge weights";
+
+        return graph.actorPath(ws, fields[1], fields[2], use_weighted_path);
+    }
+
+    if(fields[0] == "connect") {
+        int year = connections.connectedYear(graph.findNode(fields[1]), graph.findNode(fields[2]));
+        return fields[1] + '\t' + fields[2] + '\t' + to_string(year);
+    }
+
+    return "error: unknown request " + fields[0];
+}
+
+/* Answer requests on the free workspaces' threads and write their
+ * responses to out_fd in order. With timing, each response ends with
+ * the latency of its request.
+ * Return false if out_fd can no longer be written to.
+ */
+bool QueryServer::answerBatch(const vector<string>& requests, int out_fd, bool timing) {
+    if(requests.empty())
+        return true;
+
+    // Take the free workspaces, waiting for one while other clients' batches
+    // hold them all. Small batches don't take more than they have requests.
+    vector<SearchWorkspace*> batch_workspaces;
+    {
+        unique_lock<mutex> lock(poolMutex);
+        poolReady.wait(lock, [&] { return !freeWorkspaces.empty(); });
+        while(!freeWorkspaces.empty() && batch_workspaces.size() < requests.size()) {
+            batch_workspaces.push_back(freeWorkspaces.back());
+            freeWorkspaces.pop_back();
+        }
+    }
+
+    vector<string> responses(requests.size());
+    parallelForEach(batch_workspaces.size(), requests.size(), [&](unsigned t, size_t i) {
+        Timer timer;
+        timer.begin_timer();
+        responses[i] = answer(*batch_workspaces[t], requests[i]);
+        long long latency = timer.end_timer();
+
+        if(timing)
+            responses[i] += "\t" + to_string(latency) + " ns";
+    });
+
+    // Give the workspaces back before writing, so a slow reader doesn't
+    // hold up other clients
+    {
+        lock_guard<mutex> lock(poolMutex);
+        freeWorkspaces.insert(freeWorkspaces.end(), batch_workspaces.begin(), batch_workspaces.end());
+    }
+    poolReady.notify_all();
+
+    string output;
+    for(auto& response : responses) {
+        output += response;
+        output += '\n';
+    }
+
+    return writeAll(out_fd, output);
+}
+
+/* Serve requests read from in_fd, writing responses to out_fd, until
+ * in_fd is closed, a quit request is read or the server is asked to
+ * shut down. Several clients can be served at once.
+ * Return false once the server is shutting down, and true otherwise.
+ */
+bool QueryServer::serve(int in_fd, int out_fd) {
+    string buffer;
+    char chunk[1 << 16];
+    bool closed = false;
+    bool quit = false;
+
+    // Each client starts without timing
+    bool timing = false;
+
+    while(!closed && !quit) {
+        ssize_t n = read(in_fd, chunk, sizeof(chunk));
+        if(shutdownRequested)
+            return false;
+
+        if(n < 0) {
+            if(errno == EINTR)
+                continue;
+            break;
+        }
+
+        // A last request may end without a newline
+        if(n == 0) {
+            closed = true;
+            if(!buffer.empty())
+                buffer += '\n';
+        } else {
+            buffer.append(chunk, n);
+        }
+
+        // Every complete request read so far goes in one batch. Control
+        // requests apply from their position on, so they split the batch.
+        vector<string> batch;
+        size_t start = 0;
+        size_t newline;
+        while(!quit && (newline = buffer.find('\n', start)) != string::npos) {
+            string line = buffer.substr(start, newline - start);
+            start = newline + 1;
+
+            if(!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if(line.empty())
+                continue;
+
+            if(line == "quit" || line == "timing on" || line == "timing off") {
+                if(!answerBatch(batch, out_fd, timing))
+                    return !shutdownRequested;
+                batch.clear();
+
+                if(line == "quit")
+                    quit = true;
+                else
+                    timing = (line == "timing on");
+            } else {
+                batch.push_back(line);
+            }
+        }
+        buffer.erase(0, start);
+
+        if(!answerBatch(batch, out_fd, timing))
+            return !shutdownRequested;
+    }
+
+    return !shutdownRequested;
+}
+
+/* Listen on a Unix domain socket at socket_path and serve each
+ * client on its own thread until the server is asked to shut down,
+ * then close the clients' connections. The socket file is removed on
+ * shutdown.
+ * Return true if the server shut down cleanly, and false otherwise.
+ */
+bool QueryServer::serveSocket(const char* socket_path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(strlen(socket_path) >= sizeof(address.sun_path))
+        return false;
+    strcpy(address.sun_path, socket_path);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listener < 0)
+        return false;
+
+    // Replace a socket file left behind by an earlier server
+    unlink(socket_path);
+    if(bind(listener, (sockaddr*)&address, sizeof(address)) < 0 || listen(listener, 16) < 0) {
+        close(listener);
+        return false;
+    }
+
+    // Client threads, and the query threads they start, block SIGINT and
+    // SIGTERM, so the signals interrupt accept here
+    sigset_t signals, old_signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+
+    bool clean = true;
+    while(!shutdownRequested) {
+        int client = accept(listener, nullptr, nullptr);
+        if(client < 0) {
+            if(errno == EINTR)
+                continue;
+            clean = false;
+            break;
+        }
+
+        {
+            lock_guard<mutex> lock(clientsMutex);
+            clients.insert(client);
+        }
+
+        pthread_sigmask(SIG_BLOCK, &signals, &old_signals);
+        thread([this, client] {
+            serve(client, client);
+
+            lock_guard<mutex> lock(clientsMutex);
+            clients.erase(client);
+            close(client);
+            clientsDone.notify_all();
+        }).detach();
+        pthread_sigmask(SIG_SETMASK, &old_signals, nullptr);
+    }
+
+    // Wake the clients still waiting for requests, and wait for them to
+    // finish their batches
+    {
+        unique_lock<mutex> lock(clientsMutex);
+        for(int client : clients)
+            shutdown(client, SHUT_RDWR);
+        clientsDone.wait(lock, [&] { return clients.empty(); });
+    }
+
+    close(listener);
+    unlink(socket_path);
+    return clean;
+}
+
+/* Ask every running server to shut down once its current batch is
+ * answered. Safe to call from a signal handler.
+ */
+void QueryServer::requestShutdown() {
+    shutdownRequested = 1;
+}
@@ -0,0 +1,95 @@
+/* QueryServer.h
+ * Long-running server answering path and connection queries on a graph
+ * that is loaded once.
+ *
+ * Requests are lines of tab-separated fields, answered with one response
+ * line each, in request order:
+ *     path u<TAB>actor<TAB>actor    unweighted path, as pathfinder prints it
+ *     path w<TAB>actor<TAB>actor    weighted path, as pathfinder prints it
+ *     connect<TAB>actor<TAB>actor   year of connection, as actorconnections
+ *                                   ufind prints it
+ *     timing on | timing off        append each response's latency to it
+ *     quit                          close this client's connection
+ * Control requests (timing, quit) get no response. Malformed requests are
+ * answered with a line starting with "error: ".
+ *
+ * Requests arriving together are answered as one batch spread over the
+ * query threads, and their responses are written together. Socket clients
+ * are served at once, their batches sharing the query threads. The server
+ * shuts down on requestShutdown, which actorserver calls on SIGINT and
+ * SIGTERM.
+ */
+
+#ifndef QUERYSERVER_H
+#define QUERYSERVER_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include <mutex>
+#include <condition_variable>
+#include "ActorGraph.h"
+#include "ConnectionTree.h"
+#include "SearchWorkspace.h"
+
+using namespace std;
+
+class QueryServer {
+    private:
+        const ActorGraph& graph;
+
+        /* Connection years of every pair of actors */
+        ConnectionTree connections;
+
+        /* One workspace per query thread, and those no batch is using */
+        unsigned numThreads;
+        vector<SearchWorkspace> workspaces;
+        vector<SearchWorkspace*> freeWorkspaces;
+        mutex poolMutex;
+        condition_variable poolReady;
+
+        /* Connections of the socket clients being served */
+        set<int> clients;
+        mutex clientsMutex;
+        condition_variable clientsDone;
+
+        /* Return the response to a path or connect request, using ws for
+         * searches.
+         */
+        string answer(SearchWorkspace& ws, const string& request) const;
+
+        /* Answer requests on the free workspaces' threads and write their
+         * responses to out_fd in order. With timing, each response ends with
+         * the latency of its request.
+         * Return false if out_fd can no longer be written to.
+         */
+        bool answerBatch(const vector<string>& requests, int out_fd, bool timing);
+
+    public:
+        /* Prepare to serve queries on a frozen graph with num_threads query
+         * threads. The graph must outlive the server.
+         */
+        QueryServer(const ActorGraph& graph, unsigned num_threads = 1);
+
+        /* Serve requests read from in_fd, writing responses to out_fd, until
+         * in_fd is closed, a quit request is read or the server is asked to
+         * shut down. Several clients can be served at once.
+         * Return false once the server is shutting down, and true otherwise.
+         */
+        bool serve(int in_fd, int out_fd);
+
+        /* Listen on a Unix domain socket at socket_path and serve each
+         * client on its own thread until the server is asked to shut down,
+         * then close the clients' connections. The socket file is removed on
+         * shutdown.
+         * Return true if the server shut down cleanly, and false otherwise.
+         */
+        bool serveSocket(const char* socket_path);
+
+        /* Ask every running server to shut down once its current batch is
+         * answered. Safe to call from a signal handler.
+         */
+        static void requestShutdown();
+};
+
+#endif // QUERYSERVER_H
@@ -0,0 +1,51 @@
+/* SearchWorkspace.cpp
+ * Per-query search state for searches on a frozen Actor Graph.
+ */
+
+#include <algorithm>
+#include <limits>
+#include "SearchWorkspace.h"
+#include "ActorGraph.h"
+
+using namespace std;
+
+/* Allocate search state for every actor and movie of a frozen graph. */
+SearchWorkspace::SearchWorkspace(const ActorGraph& graph) :
+    epoch(0),
+    actorStamp(graph.numActors(), 0),
+    movieStamp(graph.numMovies(), 0),
+    distance(graph.numActors(), numeric_limits<int>::max()),
+    prevNode(graph.numActors(), ActorGraph::NONE),
+    prevMovie(graph.numActors(), ActorGraph::NONE),
+    done(graph.numActors(), false),
+    movieDone(graph.numMovies(), false),
+    movieDistance(graph.numMovies(), numeric_limits<int>::max()),
+    backDistance(graph.numActors(), numeric_limits<int>::max()),
+    nextNode(graph.numActors(), ActorGraph::NONE),
+    nextMovie(graph.numActors(), ActorGraph::NONE),
+    backMovieDone(graph.numMovies(), false) {}
+
+/* Start a new search. Takes constant time: actors and movies are
+ * only reset when first touched by the new search.
+ */
+void SearchWorkspace::reset() {
+    // Once the epoch wraps around, old stamps could match it again
+    if(++epoch == 0)
+        clearAll();
+}
+
+/* Reset every actor and movie to its initial state. */
+void SearchWorkspace::clearAll() {
+    fill(actorStamp.begin(), actorStamp.end(), 0);
+    fill(movieStamp.begin(), movieStamp.end(), 0);
+    fill(distance.begin(), distance.end(), numeric_limits<int>::max());
+    fill(prevNode.begin(), prevNode.end(), ActorGraph::NONE);
+    fill(prevMovie.begin(), prevMovie.end(), ActorGraph::NONE);
+    fill(done.begin(), done.end(), false);
+    fill(movieDone.begin(), movieDone.end(), false);
+    fill(movieDistance.begin(), movieDistance.end(), numeric_limits<int>::max());
+    fill(backDistance.begin(), backDistance.end(), numeric_limits<int>::max());
+    fill(nextNode.begin(), nextNode.end(), ActorGraph::NONE);
+    fill(nextMovie.begin(), nextMovie.end(), ActorGraph::NONE);
+    fill(backMovieDone.begin(), backMovieDone.end(), false);
+}
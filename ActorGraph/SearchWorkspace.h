@@ -0,0 +1,116 @@
+/* SearchWorkspace.h
+ * Per-query search state for searches on a frozen Actor Graph.
+ * Each thread running queries owns its own workspace, so the graph
+ * itself is never written to by a search.
+ */
+
+#ifndef SEARCHWORKSPACE_H
+#define SEARCHWORKSPACE_H
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+
+using namespace std;
+
+class ActorGraph;
+
+struct SearchWorkspace {
+    private:
+        /* Epoch of the current search. An actor or movie whose stamp
+         * differs from it hasn't been touched by the current search, so
+         * its state still holds values of an earlier one.
+         */
+        uint32_t epoch;
+        vector<uint32_t> actorStamp;
+        vector<uint32_t> movieStamp;
+
+        /* Reset every actor and movie to its initial state. */
+        void clearAll();
+
+    public:
+        /* Allocate search state for every actor and movie of a frozen graph. */
+        SearchWorkspace(const ActorGraph& graph);
+
+        /* Start a new search. Takes constant time: actors and movies are
+         * only reset when first touched by the new search.
+         */
+        void reset();
+
+        /* Reset the state of actor a if the current search hasn't touched
+         * it yet. Must be called before reading or writing a's state.
+         */
+        void touchActor(uint32_t a) {
+            if(actorStamp[a] == epoch)
+                return;
+
+            actorStamp[a] = epoch;
+            distance[a] = numeric_limits<int>::max();
+            prevNode[a] = numeric_limits<uint32_t>::max();
+            prevMovie[a] = numeric_limits<uint32_t>::max();
+            done[a] = false;
+            backDistance[a] = numeric_limits<int>::max();
+            nextNode[a] = numeric_limits<uint32_t>::max();
+            nextMovie[a] = numeric_limits<uint32_t>::max();
+        }
+
+        /* Reset the state of movie m if the current search hasn't touched
+         * it yet. Must be called before reading or writing m's state.
+         */
+        void touchMovie(uint32_t m) {
+            if(movieStamp[m] == epoch)
+                return;
+
+            movieStamp[m] = epoch;
+            movieDone[m] = false;
+            movieDistance[m] = numeric_limits<int>::max();
+            backMovieDone[m] = false;
+        }
+
+        /* Return the distance of actor a in the current search, INT_MAX
+         * if a hasn't been reached.
+         */
+        int distanceTo(uint32_t a) const {
+            return actorStamp[a] == epoch ? distance[a] : numeric_limits<int>::max();
+        }
+
+        /* Per-actor search state populated by BFS and Dijkstras.
+         * prevMovie is the movie ID shared with prevNode. Searches touch
+         * src and their targets, so their state and the prev data leading
+         * back from them can be read after a search.
+         */
+        vector<int> distance;
+        vector<uint32_t> prevNode;
+        vector<uint32_t> prevMovie;
+        vector<bool> done; // For Dijkstra's algorithm
+
+        /* Marks movies whose cast has already been expanded */
+        vector<bool> movieDone;
+
+        /* Shortest distance each movie's cast was expanded at, for A* */
+        vector<int> movieDistance;
+
+        /* Per-actor state of the backward half of a bidirectional search,
+         * which starts at dst. nextMovie is the movie ID shared with
+         * nextNode, the next actor on the way to dst.
+         */
+        vector<int> backDistance;
+        vector<uint32_t> nextNode;
+        vector<uint32_t> nextMovie;
+        vector<bool> backMovieDone;
+
+        /* Buckets of queued actors of Dijkstra's algorithm on a bucket
+         * queue, sized and cleared by the search itself
+         */
+        vector<vector<uint32_t>> buckets;
+
+        /* Per-node state of the upward searches from src (index 0) and
+         * dst (index 1) of a contraction hierarchy query, sized and
+         * cleared through upTouched by the query itself
+         */
+        vector<int> upDistance[2];
+        vector<uint32_t> upPrev[2];
+        vector<uint32_t> upTouched;
+};
+
+#endif // SEARCHWORKSPACE_H
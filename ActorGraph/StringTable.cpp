@@ -0,0 +1,220 @@
+/* StringTable.cpp
+ * String interning table implementation.
+ */
+
+#include <string>
+#include <algorithm>
+#include <numeric>
+#include "StringTable.h"
+
+using namespace std;
+
+const uint32_t StringTable::NONE;
+const uint32_t MovieTable::NONE;
+
+/* Return true if offsets never decrease and every entry of order is an
+ * ID of the table, as attach() needs of flattened strings.
+ */
+static bool validFlattened(ArrayView<uint32_t> offsets, ArrayView<uint32_t> order) {
+    for(size_t i = 1; i < offsets.size(); i++) {
+        if(offsets[i] < offsets[i - 1])
+            return false;
+    }
+
+    for(uint32_t id : order) {
+        if(id >= order.size())
+            return false;
+    }
+
+    return true;
+}
+
+/* Return the ID of str, adding a copy of it to the table if not present.
+ * IDs are assigned densely in insertion order starting from 0.
+ * An attached table is read-only, so NONE is returned for new strings.
+ */
+uint32_t StringTable::intern(string_view str) {
+    if(attached)
+        return find(str);
+
+    auto it = ids.find(str);
+    if(it != ids.end())
+        return it->second;
+
+    // New string: store a copy and key the map on a view of the copy
+    uint32_t id = strings.size();
+    strings.emplace_back(str);
+    ids.insert({string_view(strings.back()), id});
+
+    return id;
+}
+
+/* Return the ID of str, or NONE if str is not in the table. */
+uint32_t StringTable::find(string_view str) const {
+    if(attached) {
+        // Binary search over IDs sorted by string
+        auto it = lower_bound(order.begin(), order.end(), str,
+            [this](uint32_t id, string_view s) { return lookup(id) < s; });
+        if(it == order.end() || lookup(*it) != str)
+            return NONE;
+        return *it;
+    }
+
+    auto it = ids.find(str);
+    if(it == ids.end())
+        return NONE;
+    return it->second;
+}
+
+/* Flatten the table into the arrays read by attach(). */
+void StringTable::flatten(vector<char>& out_chars, vector<uint32_t>& out_offsets,
+    vector<uint32_t>& out_order) const {
+    uint32_t num_strings = size();
+
+    out_chars.clear();
+    out_offsets.assign(1, 0);
+    for(uint32_t id = 0; id < num_strings; id++) {
+        string_view str = lookup(id);
+        out_chars.insert(out_chars.end(), str.begin(), str.end());
+        out_offsets.push_back(out_chars.size());
+    }
+
+    out_order.resize(num_strings);
+    iota(out_order.begin(), out_order.end(), 0);
+    sort(out_order.begin(), out_order.end(),
+        [this](uint32_t a, uint32_t b) { return lookup(a) < lookup(b); });
+}
+
+/* Give the string with ID i the ID new_id[i]. new_id must hold
+ * every ID once. An attached table is copied into the table.
+ */
+void StringTable::permute(const vector<uint32_t>& new_id) {
+    uint32_t num_strings = size();
+
+    vector<uint32_t> old_id(num_strings);
+    for(uint32_t id = 0; id < num_strings; id++)
+        old_id[new_id[id]] = id;
+
+    deque<string> permuted;
+    for(uint32_t id = 0; id < num_strings; id++)
+        permuted.emplace_back(lookup(old_id[id]));
+
+    // The map's keys view the old strings, rebuild it on the new ones
+    strings.swap(permuted);
+    ids.clear();
+    ids.reserve(num_strings);
+    for(uint32_t id = 0; id < num_strings; id++)
+        ids.insert({string_view(strings[id]), id});
+
+    attached = false;
+    chars = ArrayView<char>();
+    offsets = ArrayView<uint32_t>();
+    order = ArrayView<uint32_t>();
+}
+
+/* Replace the contents of the table with flattened strings owned
+ * elsewhere, usually by a memory-mapped snapshot.
+ * Return false if the arrays are inconsistent.
+ */
+bool StringTable::attach(ArrayView<char> in_chars, ArrayView<uint32_t> in_offsets,
+    ArrayView<uint32_t> in_order) {
+    if(in_offsets.size() != in_order.size() + 1 || in_offsets[in_order.size()] != in_chars.size()
+        || !validFlattened(in_offsets, in_order))
+        return false;
+
+    strings.clear();
+    ids.clear();
+
+    chars = in_chars;
+    offsets = in_offsets;
+    order = in_order;
+    attached = true;
+
+    return true;
+}
+
+/* Return the ID of movie (title, year), adding it if not present.
+ * IDs are assigned densely in insertion order starting from 0.
+ * An attached table is read-only, so NONE is returned for new movies.
+ */
+uint32_t MovieTable::intern(string_view title, int year) {
+    if(attached)
+        return find(title, year);
+
+    auto it = ids.find(MovieKey{title, year});
+    if(it != ids.end())
+        return it->second;
+
+    // New movie: store a copy of the title and key the map on a view of it
+    uint32_t id = titles.size();
+    titles.emplace_back(title);
+    years.push_back(year);
+    ids.insert({MovieKey{string_view(titles.back()), year}, id});
+
+    return id;
+}
+
+/* Return the ID of movie (title, year), or NONE if not present. */
+uint32_t MovieTable::find(string_view title, int year) const {
+    if(attached) {
+        // Binary search over IDs sorted by year, then by title
+        auto it = lower_bound(order.begin(), order.end(), make_pair(year, title),
+            [this](uint32_t id, const pair<int, string_view>& key) {
+                return make_pair(this->year(id), this->title(id)) < key;
+            });
+        if(it == order.end() || this->year(*it) != year || this->title(*it) != title)
+            return NONE;
+        return *it;
+    }
+
+    auto it = ids.find(MovieKey{title, year});
+    if(it == ids.end())
+        return NONE;
+    return it->second;
+}
+
+/* Flatten the table into the arrays read by attach(). */
+void MovieTable::flatten(vector<char>& out_chars, vector<uint32_t>& out_offsets,
+    vector<int>& out_years, vector<uint32_t>& out_order) const {
+    uint32_t num_movies = size();
+
+    out_chars.clear();
+    out_offsets.assign(1, 0);
+    out_years.resize(num_movies);
+    for(uint32_t id = 0; id < num_movies; id++) {
+        string_view str = title(id);
+        out_chars.insert(out_chars.end(), str.begin(), str.end());
+        out_offsets.push_back(out_chars.size());
+        out_years[id] = year(id);
+    }
+
+    out_order.resize(num_movies);
+    iota(out_order.begin(), out_order.end(), 0);
+    sort(out_order.begin(), out_order.end(), [this](uint32_t a, uint32_t b) {
+        return make_pair(year(a), title(a)) < make_pair(year(b), title(b));
+    });
+}
+
+/* Replace the contents of the table with flattened movies owned
+ * elsewhere, usually by a memory-mapped snapshot.
+ * Return false if the arrays are inconsistent.
+ */
+bool MovieTable::attach(ArrayView<char> in_chars, ArrayView<uint32_t> in_offsets,
+    ArrayView<int> in_years, ArrayView<uint32_t> in_order) {
+    if(in_offsets.size() != in_order.size() + 1 || in_years.size() != in_order.size()
+        || in_offsets[in_order.size()] != in_chars.size()
+        || !validFlattened(in_offsets, in_order))
+        return false;
+
+    titles.clear();
+    years.clear();
+    ids.clear();
+
+    titleChars = in_chars;
+    titleOffsets = in_offsets;
+    yearList = in_years;
+    order = in_order;
+    attached = true;
+
+    return true;
+}
@@ -0,0 +1,171 @@
+/* StringTable.h
+ * String interning table definitions.
+ * Maps actor names and movie (title, year) keys to dense integer IDs.
+ */
+
+#ifndef STRINGTABLE_H
+#define STRINGTABLE_H
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <limits>
+#include <cstdint>
+#include "ArrayView.h"
+
+using namespace std;
+
+class StringTable {
+    private:
+        /* Interned strings indexed by ID. A deque never moves its elements,
+         * so views into them stay valid as strings are added.
+         */
+        deque<string> strings;
+
+        /* Hash map storing the interned strings.
+         * Key = View of the string stored in strings.
+         * Value = ID of that string.
+         */
+        unordered_map<string_view, uint32_t> ids;
+
+        /* Flattened strings attached from a snapshot, used instead of
+         * strings and ids when attached is true. String i is
+         * chars[offsets[i] .. offsets[i + 1]) and order lists the IDs
+         * sorted by string, for binary search.
+         */
+        bool attached;
+        ArrayView<char> chars;
+        ArrayView<uint32_t> offsets;
+        ArrayView<uint32_t> order;
+
+    public:
+        /* Marks a string that is not in the table */
+        static const uint32_t NONE = numeric_limits<uint32_t>::max();
+
+        /* Constructor */
+        StringTable() : attached(false) {}
+
+        /* The table holds views into its own strings, so it can't be copied */
+        StringTable(const StringTable&) = delete;
+        StringTable& operator=(const StringTable&) = delete;
+
+        /* Return the ID of str, adding a copy of it to the table if not present.
+         * IDs are assigned densely in insertion order starting from 0.
+         * An attached table is read-only, so NONE is returned for new strings.
+         */
+        uint32_t intern(string_view str);
+
+        /* Return the ID of str, or NONE if str is not in the table. */
+        uint32_t find(string_view str) const;
+
+        /* Return the string with the given ID. */
+        string_view lookup(uint32_t id) const {
+            if(attached)
+                return string_view(chars.data() + offsets[id], offsets[id + 1] - offsets[id]);
+            return strings[id];
+        }
+
+        /* Return the number of interned strings. */
+        uint32_t size() const { return attached ? order.size() : strings.size(); }
+
+        /* Reserve room for num_strings strings. */
+        void reserve(uint32_t num_strings) { ids.reserve(num_strings); }
+
+        /* Flatten the table into the arrays read by attach(). */
+        void flatten(vector<char>& out_chars, vector<uint32_t>& out_offsets,
+            vector<uint32_t>& out_order) const;
+
+        /* Give the string with ID i the ID new_id[i]. new_id must hold
+         * every ID once. An attached table is copied into the table.
+         */
+        void permute(const vector<uint32_t>& new_id);
+
+        /* Replace the contents of the table with flattened strings owned
+         * elsewhere, usually by a memory-mapped snapshot.
+         * Return false if the arrays are inconsistent.
+         */
+        bool attach(ArrayView<char> in_chars, ArrayView<uint32_t> in_offsets,
+            ArrayView<uint32_t> in_order);
+};
+
+class MovieTable {
+    private:
+        /* Key identifying a movie. Title views point into titles. */
+        struct MovieKey {
+            string_view title;
+            int year;
+
+            bool operator==(const MovieKey& other) const {
+                return year == other.year && title == other.title;
+            }
+        };
+
+        struct HashMovieKey {
+            size_t operator()(const MovieKey& key) const {
+                return hash<string_view>()(key.title) * 31 + key.year;
+            }
+        };
+
+        deque<string> titles;
+        vector<int> years;
+        unordered_map<MovieKey, uint32_t, HashMovieKey> ids;
+
+        /* Flattened movies attached from a snapshot, used instead of
+         * titles, years and ids when attached is true. order lists the IDs
+         * sorted by year, then by title, for binary search.
+         */
+        bool attached;
+        ArrayView<char> titleChars;
+        ArrayView<uint32_t> titleOffsets;
+        ArrayView<int> yearList;
+        ArrayView<uint32_t> order;
+
+    public:
+        /* Marks a movie that is not in the table */
+        static const uint32_t NONE = StringTable::NONE;
+
+        /* Constructor */
+        MovieTable() : attached(false) {}
+
+        /* The table holds views into its own titles, so it can't be copied */
+        MovieTable(const MovieTable&) = delete;
+        MovieTable& operator=(const MovieTable&) = delete;
+
+        /* Return the ID of movie (title, year), adding it if not present.
+         * IDs are assigned densely in insertion order starting from 0.
+         * An attached table is read-only, so NONE is returned for new movies.
+         */
+        uint32_t intern(string_view title, int year);
+
+        /* Return the ID of movie (title, year), or NONE if not present. */
+        uint32_t find(string_view title, int year) const;
+
+        /* Return the title of the movie with the given ID. */
+        string_view title(uint32_t id) const {
+            if(attached)
+                return string_view(titleChars.data() + titleOffsets[id],
+                    titleOffsets[id + 1] - titleOffsets[id]);
+            return titles[id];
+        }
+
+        /* Return the release year of the movie with the given ID. */
+        int year(uint32_t id) const { return attached ? yearList[id] : years[id]; }
+
+        /* Return the number of interned movies. */
+        uint32_t size() const { return attached ? order.size() : titles.size(); }
+
+        /* Flatten the table into the arrays read by attach(). */
+        void flatten(vector<char>& out_chars, vector<uint32_t>& out_offsets,
+            vector<int>& out_years, vector<uint32_t>& out_order) const;
+
+        /* Replace the contents of the table with flattened movies owned
+         * elsewhere, usually by a memory-mapped snapshot.
+         * Return false if the arrays are inconsistent.
+         */
+        bool attach(ArrayView<char> in_chars, ArrayView<uint32_t> in_offsets,
+            ArrayView<int> in_years, ArrayView<uint32_t> in_order);
+};
+
+#endif // STRINGTABLE_H
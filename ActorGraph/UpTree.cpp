@@ -2,243 +2,194 @@
  * Union-Find Up Tree class implementation.
  */
 
-#include <fstream>
 #include <iostream>
-#include <sstream>
 #include <string>
 #include <map>
 #include <vector>
+#include <algorithm>
 #include "UpTree.h"
+#include "Parallel.h"
+#include "CastFileReader.h"
 #include "MovieActorList.h"
 
 using namespace std;
 
+const uint32_t UpTree::NONE;
+
 /* Insert node to graph.
  * Return true if node was inserted successfully, and false otherwise.
- * Inserting duplicate actor is not allowed.
+ * Inserting duplicate actor or inserting into an up tree that shares
+ * a graph's actors is not allowed.
  */
-bool UpTree::insertNode(string actorName) {
-    try {
-        nodes.at(actorName);
+bool UpTree::insertNode(const string& actorName) {
+    if(names != &actors)
         return false;
-    }
-    catch (const std::out_of_range& oor) {
-        UpTreeNode* newNode = new UpTreeNode(actorName);   
-        nodes.insert({actorName, newNode});
-        return true;
-    }
+
+    uint32_t num_actors = actors.size();
+    if(actors.intern(actorName) != num_actors)
+        return false;
+
+    sets.add();
+    return true;
 }
 
 /* Find the node with input actorName.
- * Return pointer to the node if found.
- * Return nullpointer if not found.
+ * Return the actor ID of the node if found.
+ * Return NONE if not found.
  */
-UpTreeNode* UpTree::findNode(string actorName) {
-    try {
-        return nodes.at(actorName);
-    } catch (const std::out_of_range& oor) {
-        return nullptr;
-    }
+uint32_t UpTree::findNode(const string& actorName) const {
+    return names->find(actorName);
 }
 
 /* Disjoint set find method.
- * Return the sentinel node of query actor.
+ * Return the actor ID of the sentinel node of query actor,
+ * or NONE if actor is NONE.
  */
-UpTreeNode* UpTree::findSet(string actorName) {
-    auto curr = findNode(actorName);
-    if(!curr)
-        return nullptr;
-
-    // Vector to store nodes for path compression
-    vector<UpTreeNode*> to_update_parent;
-
-    while(curr->parent) {
-        to_update_parent.push_back(curr);
-        curr = curr->parent;
-    }
+uint32_t UpTree::findSet(uint32_t actor) {
+    if(actor == NONE)
+        return NONE;
 
-    // Path compression
-    for(auto node : to_update_parent) 
-        node->parent = curr;
-
-    return curr;
+    return sets.find(actor);
 }
 
 /* Disjoint set union method.
- * Union the sets that actorNameA and actorNameB belong.
+ * Union the sets that actors a and b belong.
  * Return true if union successfully.
  */
-bool UpTree::unionSet(string actorNameA, string actorNameB) {
-    auto a = findSet(actorNameA);
-    if(!a)
+bool UpTree::unionSet(uint32_t actorA, uint32_t actorB) {
+    if(actorA == NONE || actorB == NONE)
         return false;
 
-    auto b = findSet(actorNameB);
-    if(!b)
-        return false;
+    // Union-by-size, actor A and B may already be in the same set
+    sets.unite(actorA, actorB);
+    return true;
+}
 
-    // Actor A and B are already in the same set
-    if(a == b)
-        return true;
-
-    // Union-by-size
-    // If set A is larger than set B, A becomes the parent set
-    if(a->size > b->size) { 
-        b->parent = a;
-        b->size = 0;
-        a->size++;
-    } else {
-        a->parent = b;
-        a->size = 0;
-        b->size++;
+/* Union the sets of every actor in a movie's cast. */
+void UpTree::unionCast(const vector<uint32_t>& actorList) {
+    if(actorList.empty())
+        return;
+
+    // Connecting every actor to the first one gives the same sets as
+    // connecting every pair of them
+    if(!batchUnions) {
+        for(size_t i = 1; i < actorList.size(); i++)
+            sets.unite(actorList[0], actorList[i]);
+        return;
     }
-    return true;
+
+    // Link each distinct root once, skipping actors already in a set
+    // with an earlier one
+    castRoots.clear();
+    for(uint32_t actor : actorList)
+        castRoots.push_back(sets.find(actor));
+    sort(castRoots.begin(), castRoots.end());
+    castRoots.erase(unique(castRoots.begin(), castRoots.end()), castRoots.end());
+
+    for(size_t i = 1; i < castRoots.size(); i++)
+        sets.unite(castRoots[0], castRoots[i]);
 }
 
 /* Prepare the disjoint set for actorconnections algorithm by
  * creating a set for each actors and 
- * return pointer to a map containing movie->actors data.
+ * return pointer to a list of movie->actors data ordered by year.
+ * num_threads threads are used to parse the file.
  */
-map<string, MovieActorList*>* UpTree::prepActorConnections(const char* in_filename) {
-    // Initialize the file stream
-    ifstream infile(in_filename);
-
-    bool have_header = false;
-    
-    // Create an ordered map to store movies and list of actors in that movie
-    // Key = to_string(movie_year) + movie_title (so keys are ordered by year)
-    map<string, MovieActorList*>* movie_map = new map<string, MovieActorList*>;
-
-    // Keep reading lines until the end of file is reached
-    while(infile) {
-        string s;
-        if (!getline(infile, s)) break;
-        if (!have_header) {
-            have_header = true;
-            continue;
-        }
-        istringstream ss(s);
-        vector<string> record;
-
-        while(ss) {
-            string next;
-            if (!getline(ss, next, '\t'))
-                break;
-            record.push_back(next);
-        }
+vector<MovieActorList>* UpTree::prepActorConnections(const char* in_filename,
+    unsigned num_threads) {
+    vector<MovieActorList>* movie_list =
+        CastFileReader::readMovies(in_filename, actors, movies, num_threads);
 
-        if(record.size() != 3) {
-            continue;
-        }
+    // Each new actor gets its own set
+    sets.assign(actors.size());
 
-        string actor_name(record[0]);
-        string movie_title(record[1]);
-        int movie_year = stoi(record[2]);
-
-        // Create actor nodes (Note: Method prevents duplicates)
-        insertNode(actor_name);
-
-        // Try finding the movie in map
-        try {
-            // Movie exists. 
-            // Add actor name to movie's list.
-            MovieActorList* malist = (*movie_map).at(to_string(movie_year) + movie_title);
-            (*malist).actorList.push_back(actor_name);
-        }
-        catch (const std::out_of_range& oor) {
-            // Movie doesn't exist. 
-            // Create new MovieActorList object with actor name in list.
-            MovieActorList* new_malist = new MovieActorList(movie_title, movie_year);
-            new_malist->actorList.push_back(actor_name);
-            (*movie_map).insert({to_string(movie_year) + movie_title, new_malist});
-        }
-    }
+    return movie_list;
+}
 
-    if(!infile.eof()) {
-        cerr << "Failed to read " << in_filename << "!\n";
-        return nullptr;
-    }
-    infile.close();
+/* Prepare the disjoint set for actorconnections algorithm from the
+ * movies of a frozen graph, sharing the graph's actor IDs and names.
+ * The graph must outlive the up tree.
+ * Return pointer to a list of movie->actors data ordered by year.
+ */
+vector<MovieActorList>* UpTree::prepActorConnections(const ActorGraph& graph) {
+    names = &graph.actorTable();
+    sets.assign(names->size());
 
-    return movie_map;
+    return graph.movieList();
 }
 
 /* Run actorconnections algorithm on list of src and dst pairs.
- * Use movie data map returned from prepActorConnections.
+ * Use movie data list returned from prepActorConnections.
+ * With num_threads > 1, the movies of each year are unioned in parallel
+ * on a concurrent disjoint set, giving the same answers.
  * Return vector of actorconnections data for each input pair.
  */
-vector<string> UpTree::actorConnections
-(map<string, MovieActorList*>* movie_map, vector<string> src, vector<string> dst) {
+vector<string> UpTree::actorConnections(vector<MovieActorList>* movie_list,
+    const vector<string>& src, const vector<string>& dst, unsigned num_threads) {
     // Isolate each node into their own set
-    for(auto item : nodes) {
-        item.second->parent = nullptr;
-        item.second->size = 0;   
-    }
-
-    // Starting year of our movie data set
-    int prev_y;            
-
-    if((*movie_map).begin() == (*movie_map).end())
-        prev_y = 9999;
-    else
-        prev_y = (*movie_map).begin()->second->year;
+    sets.assign(sets.size());
+    if(num_threads > 1)
+        concurrentSets.assign(sets.size());
 
     vector<string> output;  // Vector to store output of each pair
     vector<bool> done;      // Vector to store status of each pair
+    vector<uint32_t> srcIds;
+    vector<uint32_t> dstIds;
     int num_pairs = src.size();
 
     for(int i = 0; i < num_pairs; i++) {
         output.push_back(src[i] + '\t' + dst[i] + '\t');
         done.push_back(false);
+        srcIds.push_back(findNode(src[i]));
+        dstIds.push_back(findNode(dst[i]));
     }
 
-    // For each movie
-    for(auto pair : *movie_map) {
-        MovieActorList* item = pair.second;
-        int num_actors = item->actorList.size();
-        int y = item->year;
-
-        // If this movie's year != prev movie's year, check connection for each undone pair
-        if(prev_y != y) {
-            for(int i = 0; i < num_pairs; i++) {
-                if(!done[i]) {
-                    bool connected = (findSet(src[i]) == findSet(dst[i]));
-
-                    if(connected) {
-                        output[i] += to_string(prev_y);
-                        done[i] = true;
-                    }
-                }
-            }
-
-            prev_y = y;
+    // Like findSet, two missing actors are in the same set
+    auto connected = [&](uint32_t a, uint32_t b) {
+        if(num_threads <= 1)
+            return findSet(a) == findSet(b);
+        return a == b || (a != NONE && b != NONE && concurrentSets.find(a) == concurrentSets.find(b));
+    };
+
+    // For each year, from the first movie of that year to the first of the next
+    size_t num_movies = movie_list->size();
+    size_t begin = 0;
+    while(begin < num_movies) {
+        int y = (*movie_list)[begin].year;
+        size_t end = begin;
+        while(end < num_movies && (*movie_list)[end].year == y)
+            end++;
+
+        // Union actors in this year's movies
+        if(num_threads > 1) {
+            // Movies of the same year can be unioned in any order, so each
+            // thread takes the next one until the year is done
+            parallelForEach(num_threads, end - begin, [&](unsigned, size_t m) {
+                const vector<uint32_t>& actorList = (*movie_list)[begin + m].actorList;
+                for(size_t i = 1; i < actorList.size(); i++)
+                    concurrentSets.unite(actorList[0], actorList[i]);
+            });
+        } else {
+            for(size_t m = begin; m < end; m++)
+                unionCast((*movie_list)[m].actorList);
         }
 
-        // Union actors in this movie
-        for(int i = 0; i < num_actors; i++) {
-            for(int j = i; j < num_actors; j++) {
-                unionSet(item->actorList[i], item->actorList[j]);
+        // Check connection for each undone pair once the whole year is in
+        for(int i = 0; i < num_pairs; i++) {
+            if(!done[i] && connected(srcIds[i], dstIds[i])) {
+                output[i] += to_string(y);
+                done[i] = true;
             }
         }
+
+        begin = end;
     }
-    
-    // Check connection for all undone pairs again, in case all movies are from the same year
-    for(int i = 0; i < num_pairs; i++) {
-        if(!done[i]) {
-            bool connected = (findSet(src[i]) == findSet(dst[i]));
 
-            if(connected)
-                output[i] += to_string(prev_y);
-            else
-                output[i] += "9999";
-        }
+    // Pairs still undone never become connected
+    for(int i = 0; i < num_pairs; i++) {
+        if(!done[i])
+            output[i] += "9999";
     }
-    
-    return output;
-}
 
-/* Destructor */
-UpTree::~UpTree() {
-    for(auto item : nodes)
-        delete item.second;
+    return output;
 }
@@ -9,60 +9,103 @@
 #include <unordered_map>
 #include <map>
 #include <vector>
-#include "UpTreeNode.h"
+#include <cstdint>
+#include "ConcurrentDisjointSet.h"
+#include "DisjointSet.h"
 #include "MovieActorList.h"
+#include "StringTable.h"
+#include "ActorGraph.h"
 
 using namespace std;
 
 class UpTree {
     private:
-        /* Hash map storing the nodes of the up tree. 
-         * Key = Actor name.
-         * Value = Pointer to that actor's up tree node.
+        /* Interned actor names and movies. */
+        StringTable actors;
+        MovieTable movies;
+
+        /* Table used to look up actor names. Points to actors, or to the
+         * actor table of the graph the up tree was prepared from.
+         */
+        const StringTable* names;
+
+        /* Disjoint sets of actors, keyed by actor ID. concurrentSets is
+         * used instead when movies are unioned on several threads.
          */
-        unordered_map<string, UpTreeNode*> nodes;
+        DisjointSet sets;
+        ConcurrentDisjointSet concurrentSets;
+
+        /* If true, a movie's cast is unioned through its distinct roots */
+        bool batchUnions;
+
+        /* Roots of the cast being unioned, reused across movies */
+        vector<uint32_t> castRoots;
+
+        /* Union the sets of every actor in a movie's cast. */
+        void unionCast(const vector<uint32_t>& actorList);
 
     public:
+        /* Marks a missing actor */
+        static const uint32_t NONE = StringTable::NONE;
+
         /* Constructor */
-        UpTree() {}
+        UpTree() : names(&actors), batchUnions(false) {}
 
         /* Insert node to graph.
          * Return true if node was inserted successfully, and false otherwise.
-         * Inserting duplicate actor is not allowed.
+         * Inserting duplicate actor or inserting into an up tree that shares
+         * a graph's actors is not allowed.
          */
-        bool insertNode(string actorName);
+        bool insertNode(const string& actorName);
 
         /* Find the node with input actorName.
-         * Return pointer to the node if found.
-         * Return nullpointer if not found.
+         * Return the actor ID of the node if found.
+         * Return NONE if not found.
          */
-        UpTreeNode* findNode(string actorName);
+        uint32_t findNode(const string& actorName) const;
 
         /* Disjoint set find method.
-         * Return the sentinel node of query actor.
+         * Return the actor ID of the sentinel node of query actor,
+         * or NONE if actor is NONE.
          */
-        UpTreeNode* findSet(string actorName);
+        uint32_t findSet(uint32_t actor);
 
         /* Disjoint set union method.
-         * Union the sets that actorNameA and actorNameB belong.
+         * Union the sets that actors a and b belong.
          * Return true if union successfully.
          */
-        bool unionSet(string actorNameA, string actorNameB);
+        bool unionSet(uint32_t a, uint32_t b);
+
+        /* Union a movie's cast by first finding the root of each actor,
+         * then linking each distinct root once, in order of root ID.
+         * Pays off when many cast members already share a set.
+         * Only applies to unions on a single thread.
+         */
+        void setBatchUnions(bool batch) { batchUnions = batch; }
 
         /* Prepare the disjoint set for actorconnections algorithm by
          * creating a set for each actors and 
-         * return pointer to a map containing movie->actors data.
+         * return pointer to a list of movie->actors data ordered by year.
+         * num_threads threads are used to parse the file.
          */
-        map<string, MovieActorList*>* prepActorConnections(const char* in_filename);
+        vector<MovieActorList>* prepActorConnections(const char* in_filename,
+            unsigned num_threads = 1);
+
+        /* Prepare the disjoint set for actorconnections algorithm from the
+         * movies of a frozen graph, sharing the graph's actor IDs and names.
+         * The graph must outlive the up tree.
+         * Return pointer to a list of movie->actors data ordered by year.
+         */
+        vector<MovieActorList>* prepActorConnections(const ActorGraph& graph);
 
         /* Run actorconnections algorithm on list of src and dst pairs.
-         * Use movie data map returned from prepActorConnections.
+         * Use movie data list returned from prepActorConnections.
+         * With num_threads > 1, the movies of each year are unioned in parallel
+         * on a concurrent disjoint set, giving the same answers.
          * Return vector of actorconnections data for each input pair.
          */
-        vector<string> actorConnections(map<string, MovieActorList*>* movie_map, vector<string> src, vector<string> dst);
-
-        /* Destructor */
-        ~UpTree();
+        vector<string> actorConnections(vector<MovieActorList>* movie_list,
+            const vector<string>& src, const vector<string>& dst, unsigned num_threads = 1);
 };
 
 #endif // UPTREE_H
@@ -0,0 +1,90 @@
+/* actorcentrality.cpp
+ * Program to compute the closeness, harmonic and betweenness centrality
+ * of every actor and write them as tab-separated values.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include "ActorGraph.h"
+#include "CentralityEngine.h"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    if(!(argv[1] && argv[2])) {
+        cout << "Invalid arguments. Please try again." << endl;
+        return -1;
+    }
+
+    char* movie_cast = argv[1];
+    char* out_scores = argv[2];
+
+    // Optional flags after the required arguments
+    int load_threads = 1;
+    int search_threads = 1;
+    long num_samples = 0;
+    unsigned seed = 1;
+    char* load_snapshot = nullptr;
+    for(int i = 3; i < argc; i++) {
+        string option = argv[i];
+        if(option == "--load-threads" && i + 1 < argc)
+            load_threads = atoi(argv[++i]);
+        else if(option == "-j" && i + 1 < argc)
+            search_threads = atoi(argv[++i]);
+        else if(option == "--samples" && i + 1 < argc)
+            num_samples = atol(argv[++i]);
+        else if(option == "--seed" && i + 1 < argc)
+            seed = strtoul(argv[++i], nullptr, 10);
+        else if(option == "--load-snapshot" && i + 1 < argc)
+            load_snapshot = argv[++i];
+        else {
+            cout << "Invalid option " << option << ". Please try again." << endl;
+            return -1;
+        }
+    }
+
+    if(load_threads < 1) {
+        cout << "Invalid number of load threads. Please try again." << endl;
+        return -1;
+    }
+
+    if(search_threads < 1) {
+        cout << "Invalid number of search threads. Please try again." << endl;
+        return -1;
+    }
+
+    if(num_samples < 0 || num_samples > 0xFFFFFFFFL) {
+        cout << "Invalid number of samples. Please try again." << endl;
+        return -1;
+    }
+
+    // Distances are movie hops, so the graph is loaded unweighted
+    ActorGraph g;
+    if(load_snapshot) {
+        if(!g.loadSnapshot(load_snapshot))
+            return -1;
+    } else if(!g.loadFromFile(movie_cast, false, load_threads)) {
+        return -1;
+    }
+
+    // Search from every actor, or from the sample, reporting progress
+    CentralityEngine engine(g);
+    engine.run(num_samples, seed, search_threads, &cout);
+
+    // An empty graph has no sources and takes no time, so it has no rates
+    double seconds = engine.nanoseconds()/(1000000000.00);
+    if(engine.sources() > 0 && seconds > 0) {
+        cout << "Computed centrality from " << engine.sources() << " sources in "
+            << seconds * 1000 << " ms, " << engine.sources() / seconds << " sources/s, "
+            << engine.linksScanned() / seconds / 1000000 << " million links/s" << endl;
+    } else {
+        cout << "Computed centrality from " << engine.sources() << " sources" << endl;
+    }
+
+    if(!engine.writeTSV(out_scores)) {
+        cerr << "Failed to write " << out_scores << "!\n";
+        return -1;
+    }
+
+    return 0;
+}
@@ -5,7 +5,10 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cstdlib>
 #include "ActorGraph.h"
+#include "CastFileReader.h"
+#include "ConnectionTree.h"
 #include "UpTree.h"
 #include "util.h"
 
@@ -22,8 +25,42 @@ int main(int argc, char** argv) {
     char* out_connections = argv[3];
     string alg = argv[4];
 
-    if(!(alg == "bfs" | alg == "ufind")) {
-        cout << "Invalid algorithm option (bfs or ufind only). Please try again." << endl;
+    if(!(alg == "bfs" || alg == "ufind" || alg == "offline")) {
+        cout << "Invalid algorithm option (bfs, ufind or offline only). Please try again." << endl;
+        return -1;
+    }
+
+    // Optional flags after the required arguments
+    int load_threads = 1;
+    int union_threads = 1;
+    bool batch_unions = false;
+    char* save_snapshot = nullptr;
+    char* load_snapshot = nullptr;
+    for(int i = 5; i < argc; i++) {
+        string option = argv[i];
+        if(option == "--load-threads" && i + 1 < argc)
+            load_threads = atoi(argv[++i]);
+        else if(option == "-j" && i + 1 < argc)
+            union_threads = atoi(argv[++i]);
+        else if(option == "--batch-unions")
+            batch_unions = true;
+        else if(option == "--save-snapshot" && i + 1 < argc)
+            save_snapshot = argv[++i];
+        else if(option == "--load-snapshot" && i + 1 < argc)
+            load_snapshot = argv[++i];
+        else {
+            cout << "Invalid option " << option << ". Please try again." << endl;
+            return -1;
+        }
+    }
+
+    if(load_threads < 1) {
+        cout << "Invalid number of load threads. Please try again." << endl;
+        return -1;
+    }
+
+    if(union_threads < 1) {
+        cout << "Invalid number of union threads. Please try again." << endl;
         return -1;
     }
 
@@ -71,43 +108,85 @@ int main(int argc, char** argv) {
     Timer timer;
     long long end_time;
 
-    if(alg == "bfs") {
-        ActorGraph g;
-        
-        // Build graph using movie_cast data
-        auto movie_map = g.prepActorConnections(movie_cast);
+    // Build the graph when it is needed: always for bfs, and for ufind or
+    // offline when reading or writing a snapshot. Otherwise they read
+    // movie_cast directly.
+    ActorGraph g;
+    bool use_graph = (alg == "bfs" || save_snapshot || load_snapshot);
+    if(use_graph) {
+        bool loaded;
+        if(load_snapshot)
+            loaded = g.loadSnapshot(load_snapshot);
+        else
+            loaded = g.loadFromFile(movie_cast, false, load_threads);
+
+        if(!loaded)
+            return -1;
+
+        if(save_snapshot && !g.saveSnapshot(save_snapshot))
+            return -1;
+    }
 
+    if(alg == "bfs") {
         // Run actorconnection algorithm
         timer.begin_timer();
-        auto output = g.actorConnections(movie_map, src, dst);
+        auto output = g.actorConnections(src, dst);
         end_time = timer.end_timer();
 
         // Write to outfile
         for(auto item : output)
             outfile << item << '\n';
-
-        for(auto item : *movie_map)
-            delete item.second;
-
-        delete movie_map;
-    } else {
+    } else if(alg == "ufind") {
         UpTree u;
-        // Build disjoint sets using movie_cast data
-        auto movie_map = u.prepActorConnections(movie_cast);
+        u.setBatchUnions(batch_unions);
+        // Build disjoint sets using the graph or movie_cast data
+        vector<MovieActorList>* movie_list;
+        if(use_graph)
+            movie_list = u.prepActorConnections(g);
+        else
+            movie_list = u.prepActorConnections(movie_cast, load_threads);
+
+        if(!movie_list)
+            return -1;
 
         // Run actorconnection algorithm
         timer.begin_timer();
-        auto output = u.actorConnections(movie_map, src, dst);
+        auto output = u.actorConnections(movie_list, src, dst, union_threads);
         end_time = timer.end_timer();
 
         // Write to outfile
         for (auto item : output)
             outfile << item << '\n';
 
-        for(auto item : *movie_map)
-            delete item.second;
+        delete movie_list;
+    } else {
+        // Tables of the actors and movies read from movie_cast
+        StringTable actors;
+        MovieTable movies;
+
+        vector<MovieActorList>* movie_list;
+        if(use_graph)
+            movie_list = g.movieList();
+        else
+            movie_list = CastFileReader::readMovies(movie_cast, actors, movies, load_threads);
+
+        if(!movie_list)
+            return -1;
+
+        const StringTable& names = use_graph ? g.actorTable() : actors;
+
+        // Process every movie once, then answer each pair from the tree
+        timer.begin_timer();
+        ConnectionTree tree;
+        tree.build(*movie_list, names.size());
+        auto output = tree.actorConnections(names, src, dst);
+        end_time = timer.end_timer();
+
+        // Write to outfile
+        for (auto item : output)
+            outfile << item << '\n';
 
-        delete movie_map;
+        delete movie_list;
     }
 
     outfile.close();
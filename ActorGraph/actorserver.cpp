@@ -0,0 +1,145 @@
+/* actorserver.cpp
+ * Program to load the graph once and answer path and connection queries
+ * read from stdin or a Unix domain socket until shut down.
+ */
+
+#include <iostream>
+#include <csignal>
+#include <cstdlib>
+#include <unistd.h>
+#include "ActorGraph.h"
+#include "ActorOrdering.h"
+#include "QueryServer.h"
+#include "util.h"
+
+using namespace std;
+
+/* Shut the server down on SIGINT and SIGTERM */
+static void handleSignal(int) {
+    QueryServer::requestShutdown();
+}
+
+int main(int argc, char** argv) {
+    if(!argv[1]) {
+        cout << "Invalid arguments. Please try again." << endl;
+        return -1;
+    }
+
+    char* movie_cast = argv[1];
+
+    // Optional flags after the required arguments
+    int load_threads = 1;
+    int query_threads = 1;
+    char* load_snapshot = nullptr;
+    char* socket_path = nullptr;
+    int num_landmarks = 0;
+    bool build_hierarchy = false;
+    bool compress = false;
+    string reorder = "";
+    for(int i = 2; i < argc; i++) {
+        string option = argv[i];
+        if(option == "--load-threads" && i + 1 < argc)
+            load_threads = atoi(argv[++i]);
+        else if(option == "-j" && i + 1 < argc)
+            query_threads = atoi(argv[++i]);
+        else if(option == "--load-snapshot" && i + 1 < argc)
+            load_snapshot = argv[++i];
+        else if(option == "--socket" && i + 1 < argc)
+            socket_path = argv[++i];
+        else if(option == "--landmarks" && i + 1 < argc)
+            num_landmarks = atoi(argv[++i]);
+        else if(option == "--reorder" && i + 1 < argc)
+            reorder = argv[++i];
+        else if(option == "--compress")
+            compress = true;
+        else if(option == "--hierarchy")
+            build_hierarchy = true;
+        else {
+            cout << "Invalid option " << option << ". Please try again." << endl;
+            return -1;
+        }
+    }
+
+    if(load_threads < 1) {
+        cout << "Invalid number of load threads. Please try again." << endl;
+        return -1;
+    }
+
+    if(query_threads < 1) {
+        cout << "Invalid number of query threads. Please try again." << endl;
+        return -1;
+    }
+
+    if(num_landmarks < 0) {
+        cout << "Invalid number of landmarks. Please try again." << endl;
+        return -1;
+    }
+
+    ActorOrdering::Strategy strategy = ActorOrdering::BFS_ORDER;
+    if(!(reorder.empty() || ActorOrdering::parse(reorder, strategy))) {
+        cout << "Invalid reorder option (bfs, rcm or degree only). Please try again." << endl;
+        return -1;
+    }
+
+    Timer timer;
+    timer.begin_timer();
+
+    // Weighted edges serve both kinds of path requests, since unweighted
+    // paths ignore the weights
+    ActorGraph g;
+    if(load_snapshot) {
+        if(!g.loadSnapshot(load_snapshot))
+            return -1;
+    } else if(!g.loadFromFile(movie_cast, true, load_threads)) {
+        return -1;
+    }
+
+    // Relabel the actors before anything is built on their IDs
+    if(!reorder.empty() && !g.reorderActors(strategy)) {
+        cout << "Failed to reorder actors. Please try again." << endl;
+        return -1;
+    }
+
+    if(num_landmarks > 0 && !g.buildLandmarks(num_landmarks)) {
+        cout << "Failed to build landmark index. Please try again." << endl;
+        return -1;
+    }
+
+    if(build_hierarchy && !g.buildHierarchy()) {
+        cout << "Failed to build contraction hierarchy. Please try again." << endl;
+        return -1;
+    }
+
+    if(compress && !g.compressAdjacency()) {
+        cout << "Failed to compress links. Please try again." << endl;
+        return -1;
+    }
+
+    QueryServer server(g, query_threads);
+
+    // Responses go to stdout, so progress is reported on stderr
+    cerr << "Loaded " << g.numActors() << " actors in "
+        << timer.end_timer()/(1000000.00) << " ms" << endl;
+
+    // Interrupt blocking reads and accepts instead of restarting them, so
+    // the server notices a shutdown request
+    struct sigaction action = {};
+    action.sa_handler = handleSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    // A client disconnecting mid-response must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    if(socket_path) {
+        if(!server.serveSocket(socket_path)) {
+            cout << "Failed to serve on socket " << socket_path << ". Please try again." << endl;
+            return -1;
+        }
+    } else {
+        server.serve(STDIN_FILENO, STDOUT_FILENO);
+    }
+
+    cerr << "Server shut down" << endl;
+    return 0;
+}
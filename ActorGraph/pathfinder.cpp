@@ -5,7 +5,15 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cstdlib>
+#include <algorithm>
 #include "ActorGraph.h"
+#include "ActorOrdering.h"
+#include "DirectionOptimizingBFS.h"
+#include "MultiSourceBFS.h"
+#include "QueryPlanner.h"
+#include "Parallel.h"
+#include "util.h"
 
 using namespace std;
 
@@ -31,8 +39,198 @@ int main(int argc, char** argv) {
         return -1;
     }
 
+    // Optional flags after the required arguments
+    int load_threads = 1;
+    int query_threads = 1;
+    char* save_snapshot = nullptr;
+    char* load_snapshot = nullptr;
+    char* bfs_all = nullptr;
+    string executor = "pairwise";
+    string queue = "bucket";
+    int num_landmarks = 0;
+    bool build_hierarchy = false;
+    bool build_hub_labels = false;
+    bool show_components = false;
+    bool compress = false;
+    string reorder = "";
+    for(int i = 5; i < argc; i++) {
+        string option = argv[i];
+        if(option == "--load-threads" && i + 1 < argc)
+            load_threads = atoi(argv[++i]);
+        else if(option == "-j" && i + 1 < argc)
+            query_threads = atoi(argv[++i]);
+        else if(option == "--save-snapshot" && i + 1 < argc)
+            save_snapshot = argv[++i];
+        else if(option == "--load-snapshot" && i + 1 < argc)
+            load_snapshot = argv[++i];
+        else if(option == "--executor" && i + 1 < argc)
+            executor = argv[++i];
+        else if(option == "--hierarchy")
+            build_hierarchy = true;
+        else if(option == "--hub-labels")
+            build_hub_labels = true;
+        else if(option == "--landmarks" && i + 1 < argc)
+            num_landmarks = atoi(argv[++i]);
+        else if(option == "--queue" && i + 1 < argc)
+            queue = argv[++i];
+        else if(option == "--reorder" && i + 1 < argc)
+            reorder = argv[++i];
+        else if(option == "--compress")
+            compress = true;
+        else if(option == "--components")
+            show_components = true;
+        else if(option == "--bfs-all" && i + 1 < argc)
+            bfs_all = argv[++i];
+        else {
+            cout << "Invalid option " << option << ". Please try again." << endl;
+            return -1;
+        }
+    }
+
+    if(load_threads < 1) {
+        cout << "Invalid number of load threads. Please try again." << endl;
+        return -1;
+    }
+
+    if(query_threads < 1) {
+        cout << "Invalid number of query threads. Please try again." << endl;
+        return -1;
+    }
+
+    if(!(executor == "pairwise" || executor == "grouped" || executor == "msbfs")) {
+        cout << "Invalid executor (pairwise, grouped or msbfs only). Please try again." << endl;
+        return -1;
+    }
+
+    if(num_landmarks < 0) {
+        cout << "Invalid number of landmarks. Please try again." << endl;
+        return -1;
+    }
+
+    if(!(queue == "bucket" || queue == "heap")) {
+        cout << "Invalid queue option (bucket or heap only). Please try again." << endl;
+        return -1;
+    }
+
+    ActorOrdering::Strategy strategy = ActorOrdering::BFS_ORDER;
+    if(!(reorder.empty() || reorder == "none" || ActorOrdering::parse(reorder, strategy))) {
+        cout << "Invalid reorder option (none, bfs, rcm or degree only). Please try again." << endl;
+        return -1;
+    }
+
+    if(compress && (executor == "msbfs" || bfs_all)) {
+        cout << "The msbfs executor and --bfs-all need uncompressed links. Please try again." << endl;
+        return -1;
+    }
+
+    if(executor == "msbfs" && use_weighted_path) {
+        cout << "The msbfs executor only finds unweighted paths. Please try again." << endl;
+        return -1;
+    }
+
+    // Load the graph from the snapshot instead of movie_cast if given
     ActorGraph g;
-    g.loadFromFile(movie_cast, use_weighted_path);
+    if(load_snapshot) {
+        if(!g.loadSnapshot(load_snapshot))
+            return -1;
+
+        if(use_weighted_path && !g.isWeighted()) {
+            cout << "Snapshot " << load_snapshot << " has no edge weights. Please try again." << endl;
+            return -1;
+        }
+    } else {
+        g.loadFromFile(movie_cast, use_weighted_path, load_threads);
+    }
+
+    // Relabel the actors before anything is built on their IDs. "none"
+    // only reports the gap and query time, to compare orders against.
+    if(!reorder.empty()) {
+        double gap = ActorOrdering::averageCastGap(g.csrView());
+        if(reorder != "none") {
+            Timer timer;
+            timer.begin_timer();
+            if(!g.reorderActors(strategy)) {
+                cout << "Failed to reorder actors. Please try again." << endl;
+                return -1;
+            }
+
+            cout << "Reordered actors by " << reorder << " in "
+                << timer.end_timer()/(1000000.00) << " ms" << endl;
+        }
+
+        cout << "Average cast ID gap " << gap << " before, "
+            << ActorOrdering::averageCastGap(g.csrView()) << " after" << endl;
+    }
+
+    // Build the landmark index, contraction hierarchy and hub labels before
+    // saving so the snapshot includes them
+    if(num_landmarks > 0 && !g.buildLandmarks(num_landmarks)) {
+        cout << "Failed to build landmark index. Please try again." << endl;
+        return -1;
+    }
+
+    if(build_hierarchy && !g.buildHierarchy()) {
+        cout << "Failed to build contraction hierarchy. Please try again." << endl;
+        return -1;
+    }
+
+    if(build_hub_labels) {
+        if(!g.buildHubLabels(load_threads)) {
+            cout << "Failed to build hub labels. Please try again." << endl;
+            return -1;
+        }
+
+        cout << "Built " << g.numHubLabels() << " hub labels, "
+            << (double)g.numHubLabels() / max(g.numActors(), 1u) << " per actor" << endl;
+    }
+
+    if(save_snapshot && !g.saveSnapshot(save_snapshot))
+        return -1;
+
+    // Compress the links last, nothing can be built or saved from them
+    if(compress) {
+        size_t plain_bytes = g.adjacencyBytes();
+        if(!g.compressAdjacency()) {
+            cout << "Failed to compress links. Please try again." << endl;
+            return -1;
+        }
+
+        cout << "Compressed links from " << plain_bytes/(1048576.00) << " MB to "
+            << g.adjacencyBytes()/(1048576.00) << " MB" << endl;
+    }
+
+    if(queue == "heap")
+        g.setDijkstraQueue(ActorGraph::HEAP_QUEUE);
+
+    // Report how many connected components there are of each size
+    if(show_components) {
+        cout << "Found " << g.numComponents() << " components" << endl;
+        for(auto& entry : g.componentSizeDistribution())
+            cout << entry.second << " components of " << entry.first << " actors" << endl;
+    }
+
+    // Report distances from one actor to the whole graph, level by level
+    if(bfs_all) {
+        uint32_t id = g.findNode(bfs_all);
+        if(id == ActorGraph::NONE) {
+            cout << "Actor " << bfs_all << " not found. Please try again." << endl;
+            return -1;
+        }
+
+        DirectionOptimizingBFS engine(g.csrView());
+        auto& distance = engine.bfsAll(id);
+
+        for(auto& level : engine.levelStats()) {
+            cout << "Level " << level.depth << ": " << level.frontierSize << " actors, "
+                << level.frontierEdges << " movie links, "
+                << (level.bottomUp ? "bottom-up" : "top-down") << ", "
+                << level.nanoseconds/(1000000.00) << " ms" << endl;
+        }
+
+        uint32_t reached = count_if(distance.begin(), distance.end(),
+            [](int d) { return d != numeric_limits<int>::max(); });
+        cout << "Reached " << reached << " of " << g.numActors() << " actors" << endl;
+    }
 
     // Read pair from test_pairs
     vector<string> src;
@@ -76,9 +274,38 @@ int main(int argc, char** argv) {
     ofstream outfile(out_paths);
     outfile << "(actor)--[movie#@year]-->(actor)--..." << '\n';
 
-    // Run pathfinder algorithm for each pair and write output to outfile
-    for(int i = 0; i < src.size(); i++)
-        outfile << g.actorPath(src[i], dst[i], use_weighted_path) << '\n';
+    Timer query_timer;
+    query_timer.begin_timer();
+
+    vector<string> paths;
+    if(executor == "msbfs") {
+        // Search up to 64 sources per traversal, batches spread over
+        // query_threads threads
+        paths = MultiSourceBFS::actorPaths(g, src, dst, query_threads);
+    } else if(executor == "grouped") {
+        // Search once per distinct source for all of its destinations
+        QueryPlanner planner(g);
+        paths = planner.actorPaths(src, dst, use_weighted_path, query_threads);
+        cout << "Ran " << planner.searches() << " searches for " << src.size()
+            << " pairs, saving " << planner.searchesSaved() << endl;
+    } else {
+        // Run pathfinder algorithm for each pair on a pool of query_threads
+        // threads, each with its own search workspace
+        paths.resize(src.size());
+        vector<SearchWorkspace> workspaces(query_threads, SearchWorkspace(g));
+        parallelForEach(query_threads, src.size(), [&](unsigned t, size_t i) {
+            paths[i] = g.actorPath(workspaces[t], src[i], dst[i], use_weighted_path);
+        });
+    }
+
+    if(!reorder.empty()) {
+        cout << "Answered " << paths.size() << " queries in "
+            << query_timer.end_timer()/(1000000.00) << " ms" << endl;
+    }
+
+    // Write output to outfile in input order
+    for(auto& path : paths)
+        outfile << path << '\n';
 
     outfile.close();
     return 0;